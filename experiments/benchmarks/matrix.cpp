@@ -0,0 +1,88 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include "functions/Matrix.h"
+#include "DataTypeHandling.h"
+
+// The textbook cholesky decomposition (Cholesky–Banachiewicz) with scalar inner sums. This is the baseline.
+Matrix cholesky_reference(Matrix const &in, unsigned int N_sub) {
+    Matrix L(N_sub);
+
+    for (unsigned int j = 0; j < N_sub; ++j) {
+        data_t sum = 0.0;
+        for (unsigned int k = 0; k < j; ++k) {
+            sum += L(j,k)*L(j,k);
+        }
+        L(j,j) = std::sqrt(in(j,j) - sum);
+
+        for (unsigned int i = j + 1; i < N_sub; ++i) {
+            data_t sum = 0.0;
+            for (unsigned int k = 0; k < j; ++k) {
+                sum += L(i,k) * L(j,k);
+            }
+            L(i,j) = (in(i,j) - sum) / L(j,j);
+        }
+    }
+    return L;
+}
+
+// Generates a random N x N positive definite matrix A = B B^T / N + I
+Matrix random_spd(unsigned int N, std::mt19937 &gen) {
+    std::normal_distribution<data_t> dist(0, 1);
+    Matrix B(N);
+    for (unsigned int i = 0; i < N; ++i) {
+        for (unsigned int j = 0; j < N; ++j) {
+            B(i,j) = dist(gen);
+        }
+    }
+
+    Matrix A(N);
+    for (unsigned int i = 0; i < N; ++i) {
+        for (unsigned int j = 0; j <= i; ++j) {
+            data_t s = dot(B.row(i), B.row(j), N) / N;
+            A(i,j) = s + (i == j ? 1.0 : 0.0);
+            A(j,i) = A(i,j);
+        }
+    }
+    return A;
+}
+
+// Returns the average runtime of f in microseconds
+template <typename F>
+double measure(F f, unsigned int repetitions) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; ++r) {
+        f();
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::micro> runtime = end - start;
+    return runtime.count() / repetitions;
+}
+
+int main() {
+    std::mt19937 gen(12345);
+    std::vector<unsigned int> sizes = {10, 20, 50, 100, 200, 500, 1000};
+
+    std::cout << "N,reference_us,log_det_us,log_det_workspace_us,speedup,abs_error" << std::endl;
+    for (auto N : sizes) {
+        Matrix A = random_spd(N, gen);
+        Matrix workspace(N);
+        unsigned int repetitions = std::max(1u, 20000000u / (N * N * N));
+
+        volatile data_t sink = 0;
+        data_t ref = log_det_from_cholesky(cholesky_reference(A, N));
+        data_t err = std::abs(ref - log_det(A, N, workspace));
+
+        double t_ref = measure([&]() { sink = log_det_from_cholesky(cholesky_reference(A, N)); }, repetitions);
+        double t_new = measure([&]() { sink = log_det(A, N); }, repetitions);
+        double t_ws = measure([&]() { sink = log_det(A, N, workspace); }, repetitions);
+        (void)sink;
+
+        std::cout << N << "," << t_ref << "," << t_new << "," << t_ws << "," << t_ref / t_ws << "," << err << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cmath>
+
+#include "DataTypeHandling.h"
+#include "Greedy.h"
+#include "StochasticGreedy.h"
+#include "functions/FastIVM.h"
+#include "functions/kernels/RBFKernel.h"
+
+// Generates N samples with d features which lie close to a random 5-dimensional subspace, similar to real (normalized)
+// data with few informative directions. The shapes below mimic the (preprocessed) data sets in experiments/
+std::vector<std::vector<data_t>> random_data(unsigned int N, unsigned int d, std::mt19937 &gen) {
+    unsigned int latent = 5;
+    std::normal_distribution<data_t> dist(0, 1);
+
+    std::vector<std::vector<data_t>> A(d, std::vector<data_t>(latent));
+    for (auto &a : A) {
+        for (auto &v : a) {
+            v = 0.3 * dist(gen) / std::sqrt(latent);
+        }
+    }
+
+    std::vector<std::vector<data_t>> X(N, std::vector<data_t>(d));
+    std::vector<data_t> z(latent);
+    for (auto &x : X) {
+        for (auto &v : z) {
+            v = dist(gen);
+        }
+        for (unsigned int i = 0; i < d; ++i) {
+            x[i] = 0.01 * dist(gen);
+            for (unsigned int j = 0; j < latent; ++j) {
+                x[i] += A[i][j] * z[j];
+            }
+        }
+    }
+    return X;
+}
+
+// Returns the runtime of f in seconds
+template <typename F>
+double measure(F f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> runtime = end - start;
+    return runtime.count();
+}
+
+int main() {
+    std::mt19937 gen(12345);
+
+    // name, number of features
+    std::vector<std::pair<std::string, unsigned int>> shapes = {
+        {"creditfraud", 29}, {"kddcup99", 41}, {"forestcover", 54}
+    };
+    unsigned int N = 20000;
+    std::vector<unsigned int> Ks = {10, 50};
+    std::vector<data_t> epsilons = {0.5, 0.1, 0.01, 0.001};
+
+    std::cout << "data,N,d,K,epsilon,greedy_fval,stochastic_fval,relative_fval,greedy_s,stochastic_s,speedup" << std::endl;
+    for (auto const & [name, d] : shapes) {
+        auto X = random_data(N, d, gen);
+
+        for (auto K : Ks) {
+            // Same kernel parameters as in the experiments
+            FastIVM fastIVM(K, RBFKernel(std::sqrt(d), 1.0), 1.0);
+
+            Greedy greedy(K, fastIVM);
+            double t_greedy = measure([&]() { greedy.fit(X); });
+
+            for (auto eps : epsilons) {
+                StochasticGreedy stochastic(K, fastIVM, eps, 12345);
+                double t_stochastic = measure([&]() { stochastic.fit(X); });
+
+                std::cout << name << "," << N << "," << d << "," << K << "," << eps << "," 
+                          << greedy.get_fval() << "," << stochastic.get_fval() << "," << stochastic.get_fval() / greedy.get_fval() << ","
+                          << t_greedy << "," << t_stochastic << "," << t_greedy / t_stochastic << std::endl;
+            }
+        }
+    }
+
+    return 0;
+}
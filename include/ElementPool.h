@@ -0,0 +1,243 @@
+#ifndef ELEMENTPOOL_H
+#define ELEMENTPOOL_H
+
+#include <vector>
+#include <memory>
+#include <optional>
+
+#include "DataTypeHandling.h"
+#include "SubmodularFunction.h"
+
+/**
+ * @brief  A reference-counted pool of the distinct elements stored by the sieves of a multi-sieve optimizer (e.g. SieveStreaming or SieveStreamingPP). Usually many sieves store the same element, so that the pool is much smaller than the total number of elements stored across all sieves. Each sieve keeps the slots of its elements (see SubmodularFunction::peek_pooled) so that quantities like the kernel values between a new element and all stored elements are computed once per element via SubmodularFunction::pool_row instead of once per sieve.
+ * Slots of elements which are no longer referenced by any sieve are re-used for new elements. The pool also caches the pool_row of the current element of the stream and its slot, so that both are computed at most once per element, no matter how many sieves peek at or accept it.
+ */
+class ElementPool {
+private:
+    // The elements. Each element is stored separately so that pointers to it remain valid if the pool grows.
+    std::vector<std::unique_ptr<std::vector<data_t>>> elements;
+
+    // Pointers to the elements or nullptr if the slot is currently unused
+    std::vector<std::vector<data_t> const *> slots;
+
+    // The number of references to each slot
+    std::vector<unsigned int> refs;
+
+    // Unused slots which can be re-used by `insert`
+    std::vector<unsigned int> free_slots;
+
+    // The function which is used to compute the pool_row
+    std::shared_ptr<SubmodularFunction> f;
+
+    // The current element of the stream, its pool_row and its slot (if it has been inserted already)
+    std::vector<data_t> const * current;
+    std::vector<data_t> row;
+    bool has_row;
+    std::vector<data_t> * current_row;
+    std::optional<unsigned int> current_slot;
+
+    // The slots and pool_rows of the elements of the current block (see insert_block), whether each pool_row has been computed already and the position of the current element in the block
+    std::vector<unsigned int> block_slots;
+    std::vector<std::vector<data_t>> block_rows;
+    std::vector<bool> block_has_row;
+    std::optional<unsigned int> current_block;
+
+    // The pool without the elements of the current block. The pool_rows of the block are computed for these elements only.
+    std::vector<std::vector<data_t> const *> block_pool;
+
+    // The elements of the block which have been accepted by any sieve in the order they were accepted, whether each element has been
+    // accepted and the number of accepted elements which are already covered by the pool_row of each element of the block
+    std::vector<unsigned int> block_accepted;
+    std::vector<bool> block_is_accepted;
+    std::vector<unsigned int> block_covered;
+
+    // Buffers to add the accepted elements of the block to a pool_row
+    std::vector<std::vector<data_t> const *> missing;
+    std::vector<unsigned int> missing_pos;
+    std::vector<data_t> missing_row;
+
+public:
+
+    /**
+     * @brief  Creates a new, empty pool.
+     * @param  f: The function which is used to compute the pool_row of each element. This is usually the function of the optimizer owning this pool.
+     */
+    ElementPool(std::shared_ptr<SubmodularFunction> f) : f(f), current(nullptr), has_row(false), current_row(&row) {}
+
+    /**
+     * @brief  Sets the current element of the stream. This invalidates the cached pool_row and slot of the previous element. 
+     * @param  &x: The current element. The caller has to make sure it outlives all calls to `get_row` and `insert_current`.
+     */
+    void set_current(std::vector<data_t> const &x) {
+        current = &x;
+        has_row = false;
+        current_row = &row;
+        current_slot.reset();
+        current_block.reset();
+    }
+
+    /**
+     * @brief  Returns the pool_row of the current element (see SubmodularFunction::pool_row). It is computed on the first call after `set_current` or `set_current_block`.
+     */
+    std::vector<data_t> const & get_row() {
+        if (!current_block.has_value()) {
+            if (!has_row) {
+                f->pool_row(slots, *current, row);
+                has_row = true;
+            }
+            return row;
+        }
+
+        unsigned int j = current_block.value();
+        if (!has_row) {
+            f->pool_row(block_pool, *current, *current_row);
+            has_row = true;
+            block_has_row[j] = true;
+            block_covered[j] = 0;
+        }
+
+        // A sieve may only have accepted elements of the block which come before the current one, hence only these are added to its pool_row.
+        // Functions which do not support the pool leave the pool_row empty.
+        if (block_covered[j] < block_accepted.size() && !current_row->empty()) {
+            missing.clear();
+            missing_pos.clear();
+            for (unsigned int i = block_covered[j]; i < block_accepted.size(); ++i) {
+                if (block_accepted[i] < j) {
+                    missing.push_back(elements[block_slots[block_accepted[i]]].get());
+                    missing_pos.push_back(block_accepted[i]);
+                }
+            }
+            if (missing.size() > 0) {
+                f->pool_row(missing, *current, missing_row);
+                for (unsigned int i = 0; i < missing_pos.size(); ++i) {
+                    (*current_row)[block_slots[missing_pos[i]]] = missing_row[i];
+                }
+            }
+            block_covered[j] = block_accepted.size();
+        }
+        return *current_row;
+    }
+
+    /**
+     * @brief  Inserts all elements of a block of the stream into the pool. This allows multi-sieve optimizers to process a block sieve-by-sieve instead of element-by-element: All elements of the block receive their slot beforehand, so that a sieve can accept an element of the block while another sieve has already peeked at later elements. The pool_row of each element is computed on the first call of `get_row` for the elements which were in the pool before the block and is then extended by the elements of the block which have been accepted by any sieve in the meantime. Each element of the block is retained once by the pool itself until `release_block` is called, so that no slot is re-used during the block.
+     * @param  &X: The data.
+     * @param  begin: The first element of the block.
+     * @param  end: One past the last element of the block.
+     */
+    void insert_block(std::vector<std::vector<data_t>> const &X, unsigned int begin, unsigned int end) {
+        block_slots.resize(end - begin);
+        for (unsigned int j = begin; j < end; ++j) {
+            block_slots[j - begin] = insert(X[j]);
+            retain(block_slots[j - begin]);
+        }
+
+        block_pool = slots;
+        for (auto slot : block_slots) {
+            block_pool[slot] = nullptr;
+        }
+
+        block_rows.resize(end - begin);
+        block_has_row.assign(end - begin, false);
+        block_covered.assign(end - begin, 0);
+        block_accepted.clear();
+        block_is_accepted.assign(end - begin, false);
+    }
+
+    /**
+     * @brief  Sets the j-th element of the current block as the current element. Its slot is already known, so that `insert_current` is free, and its pool_row is only computed once for the entire block (see `get_row`).
+     * @param  j: The position of the element in the block.
+     */
+    void set_current_block(unsigned int j) {
+        current = elements[block_slots[j]].get();
+        current_row = &block_rows[j];
+        has_row = block_has_row[j];
+        current_slot = block_slots[j];
+        current_block = j;
+    }
+
+    /**
+     * @brief  Releases the references of the pool to the elements of the current block. Elements which have not been retained by any sieve are removed.
+     */
+    void release_block() {
+        for (auto slot : block_slots) {
+            release(slot);
+        }
+        block_slots.clear();
+        current = nullptr;
+        has_row = false;
+        current_row = &row;
+        current_slot.reset();
+        current_block.reset();
+    }
+
+    /**
+     * @brief  Inserts the current element into the pool on the first call after `set_current`. Later calls return the same slot. The caller should retain the slot.
+     * @retval The slot of the current element.
+     */
+    unsigned int insert_current() {
+        if (current_block.has_value() && !block_is_accepted[current_block.value()]) {
+            block_is_accepted[current_block.value()] = true;
+            block_accepted.push_back(current_block.value());
+        }
+        if (!current_slot.has_value()) {
+            current_slot = insert(*current);
+        }
+        return current_slot.value();
+    }
+
+    /**
+     * @brief  Inserts a new element into the pool. The new element has no references and should be retained by the caller.
+     * @param  &x: The element.
+     * @retval The slot of the new element.
+     */
+    unsigned int insert(std::vector<data_t> const &x) {
+        unsigned int slot;
+        if (free_slots.size() > 0) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            *elements[slot] = x;
+        } else {
+            slot = elements.size();
+            elements.push_back(std::make_unique<std::vector<data_t>>(x));
+            slots.push_back(nullptr);
+            refs.push_back(0);
+        }
+        slots[slot] = elements[slot].get();
+        return slot;
+    }
+
+    /**
+     * @brief  Adds a reference to the given slot.
+     * @param  slot: The slot.
+     */
+    void retain(unsigned int slot) {
+        ++refs[slot];
+    }
+
+    /**
+     * @brief  Removes a reference from the given slot. If there are no references left, the slot is marked unused.
+     * @param  slot: The slot.
+     */
+    void release(unsigned int slot) {
+        if (--refs[slot] == 0) {
+            slots[slot] = nullptr;
+            free_slots.push_back(slot);
+        }
+    }
+
+    /**
+     * @brief  Returns pointers to all elements indexed by their slot. Unused slots are nullptr.
+     */
+    std::vector<std::vector<data_t> const *> const & get_slots() const {
+        return slots;
+    }
+
+    /**
+     * @brief  Returns the number of (distinct) elements currently stored in the pool.
+     */
+    unsigned long size() const {
+        return elements.size() - free_slots.size();
+    }
+};
+
+#endif // ELEMENTPOOL_H
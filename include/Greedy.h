@@ -79,19 +79,21 @@ public:
         std::vector<unsigned int> remaining(X.size());
         std::iota(remaining.begin(), remaining.end(), 0);
         data_t fcur = 0;
+        std::vector<data_t> fvals;
 
         while(solution.size() < K && remaining.size() > 0) {
-            std::vector<data_t> fvals;
-            fvals.reserve(remaining.size());
-            
             // Technically the Greedy algorithms picks that element with largest gain. This is equivalent to picking that
-            // element which results in the largest function value. There is no need to explicitly compute the gain
-            for (auto i : remaining) {
-                data_t ftmp = f->peek(solution, X[i], solution.size());
-                fvals.push_back(ftmp);
-            }
+            // element which results in the largest function value. There is no need to explicitly compute the gain.
+            // All remaining candidates are peeked at once, so that the function can share work between them
+            f->peek_batch(solution, X, remaining, fvals);
 
-            unsigned int max_element = std::distance(fvals.begin(),std::max_element(fvals.begin(), fvals.end()));
+            // Ties are broken towards the smaller index so that the result does not depend on the order of remaining
+            unsigned int max_element = 0;
+            for (unsigned int i = 1; i < remaining.size(); ++i) {
+                if (fvals[i] > fvals[max_element] || (fvals[i] == fvals[max_element] && remaining[i] < remaining[max_element])) {
+                    max_element = i;
+                }
+            }
             fcur = fvals[max_element];
             unsigned int max_idx = remaining[max_element];
             
@@ -102,7 +104,9 @@ public:
             if (ids.size() >= max_idx) {
                 this->ids.push_back(max_idx);
             }
-            remaining.erase(remaining.begin()+max_element);
+            // The order of the remaining elements does not matter, hence we remove the selected one in O(1)
+            remaining[max_element] = remaining.back();
+            remaining.pop_back();
         }
 
         fval = fcur;
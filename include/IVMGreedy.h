@@ -0,0 +1,170 @@
+#ifndef IVM_GREEDY_H
+#define IVM_GREEDY_H
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include "functions/IVM.h"
+#include "functions/Matrix.h"
+#include <algorithm>
+#include <numeric>
+#include <limits>
+#include <cmath>
+
+/**
+ * @brief  A Greedy optimizer which is specialized for the IVM (and thereby the FastIVM). It selects the same summary as the Greedy optimizer, but it maintains a partial cholesky decomposition for every candidate instead of re-peeking each remaining candidate in every round. Let \f$ A = \Sigma + \sigma \cdot \mathcal I\f$ be the kernel matrix of the entire data set. For every candidate i we store the i-th row \f$ c_i \f$ of the cholesky decomposition of A restricted to the current summary and the marginal gain \f$ d_i^2 \f$ so that \f$ f(S \cup \{i\}) = f(S) + \log d_i^2 \f$. In each round we select the candidate j with the largest \f$ d_j^2 \f$ and then extend each \f$ c_i \f$ by one entry with
+ * \f[
+ *      e_i = \frac{A_{ji} - \langle c_j, c_i\rangle}{d_j}, \quad d_i^2 \leftarrow d_i^2 - e_i^2 
+ * \f]
+ * Hence, each round requires only one kernel column between the newly selected element and all candidates.
+ *  - Stream:  No
+ *  - Solution: \f$ 1 - 1/\exp(1) \f$
+ *  - Runtime: \f$ O(N \cdot K^2) \f$ flops and \f$ O(N \cdot K) \f$ kernel evaluations
+ *  - Memory: \f$ O(N \cdot K) \f$
+ *  - Function Queries per Element: \f$ O(1) \f$
+ *  - Function Types: IVM / FastIVM
+ * 
+ * Example usage in C++:
+ * @code{.cpp}
+ *  //read some data 
+ *  std::vector<std::vector<data_t>> = read_some_data(); 
+ *  auto K = 50;
+ *  // Define the function to be maximized and select the summary
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(data[0].size()), 1.0) , 1.0);
+ *  IVMGreedy opt(K, fastIVM);
+ *  opt.fit(data);
+ *  std::cout << "fval:" << opt.get_fval() << "num_elements: " << opt.get_num_elements_stored() << "num_candidates: " << opt.get_num_candidate_solutions() << std::endl;
+ *  // Process summary
+ *  auto summary = opt.get_solution();
+ * @endcode
+ * 
+ * Example usage in Python:
+ * @code{.py}
+ *  X = read_some_data(); 
+ *  K = 50
+ *  # Create function to be maximized
+ *  kernel = RBFKernel(sigma=sigma,scale=scale)
+ *  fastLogDet = FastIVM(K, kernel, 1.0)
+ *  opt = IVMGreedy(K, fastLogDet)
+ *  opt.fit(X, K)
+ *  print("fval: {} num_elements: {} num_candidates: {}".format(opt.get_fval(), opt.get_num_elements_stored(), opt.get_num_candidate_solutions()))
+ *  # process summary
+ *  summary = opt.get_solution()
+ * @endcode
+ * 
+ * __References__
+ * 
+ * - Chen, L., Zhang, G., & Zhou, E. (2018). Fast Greedy MAP Inference for Determinantal Point Process to Improve Recommendation Diversity. In S. Bengio, H. Wallach, H. Larochelle, K. Grauman, N. Cesa-Bianchi, & R. Garnett (Eds.), Advances in Neural Information Processing Systems (Vol. 31). Curran Associates, Inc. Retrieved from https://proceedings.neurips.cc/paper/2018/file/dbbf603ff0e99629dda5d75b6f75f966-Paper.pdf
+ */
+class IVMGreedy : public SubmodularOptimizer {
+protected:
+    // The kernel of the IVM
+    std::shared_ptr<Kernel> kernel;
+
+    // The scaling constant of the IVM
+    data_t sigma;
+
+public:
+    
+    /**
+     * @brief Construct a new IVMGreedy object
+     * 
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The IVM (or FastIVM) which should be maximized. Its kernel is cloned and used directly, the function itself is only used to determine the kernel and sigma.
+     */
+    IVMGreedy(unsigned int K, IVM & f) : SubmodularOptimizer(K,f), kernel(f.get_kernel().clone()), sigma(f.get_sigma()) {}
+
+    /**
+     * @brief Construct a new IVMGreedy object
+     * 
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param kernel The kernel of the IVM which should be maximized. Note, that this parameter is likely moved and not copied.
+     * @param sigma The scaling constant of the IVM which should be maximized.
+     */
+    IVMGreedy(unsigned int K, std::function<data_t (std::vector<data_t> const &, std::vector<data_t> const &)> kernel, data_t sigma) 
+        : IVMGreedy(K, *std::make_shared<IVM>(kernel, sigma)) {}
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset. Repeat this until K element have been selected. You can access the solution via `get_solution` and the corresponding ids (if passed) with `get_ids()`
+     * 
+     * @param X A constant reference to the entire data set
+     * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks. 
+     * @param iterations: Has no effect. IVMGreedy iterates K times over the entire dataset in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
+        unsigned int N = X.size();
+
+        // The partial cholesky rows (row-major, K entries per candidate) and the marginal gains of all candidates
+        std::vector<data_t> C(static_cast<size_t>(N) * K, 0);
+        std::vector<data_t> d2(N);
+        for (unsigned int i = 0; i < N; ++i) {
+            d2[i] = sigma * 1.0 + kernel->operator()(X[i], X[i]);
+        }
+
+        // Pointers to all candidates and the kernel column of the element selected last for Kernel::block
+        std::vector<std::vector<data_t> const *> candidates(N);
+        for (unsigned int i = 0; i < N; ++i) {
+            candidates[i] = &X[i];
+        }
+        std::vector<data_t> kcol(N);
+        std::vector<bool> selected(N, false);
+
+        data_t fcur = 0;
+        while(solution.size() < K && solution.size() < N) {
+            unsigned int j = 0;
+            data_t best = -std::numeric_limits<data_t>::infinity();
+            for (unsigned int i = 0; i < N; ++i) {
+                if (!selected[i] && d2[i] > best) {
+                    best = d2[i];
+                    j = i;
+                }
+            }
+
+            fcur += std::log(best);
+            selected[j] = true;
+            solution.push_back(X[j]);
+            if (ids.size() > j) {
+                this->ids.push_back(ids[j]);
+            }
+
+            unsigned int k = solution.size() - 1;
+            if (k + 1 == K) break;
+
+            kernel->block({&X[j]}, candidates, kcol.data(), N);
+            data_t const dj = std::sqrt(best);
+            data_t const * const cj = &C[static_cast<size_t>(j) * K];
+            for (unsigned int i = 0; i < N; ++i) {
+                if (!selected[i]) {
+                    data_t * const ci = &C[static_cast<size_t>(i) * K];
+                    data_t e = (kcol[i] - dot(cj, ci, k)) / dj;
+                    ci[k] = e;
+                    d2[i] -= e * e;
+                }
+            }
+        }
+
+        fval = fcur;
+        is_fitted = true;
+    }
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset. Repeat this until K element have been selected. You can access the solution via `get_solution`
+     * @note This internally calls fit with an empty id set.
+     * @param X A constant reference to the entire data set
+     * @param iterations: Has no effect. IVMGreedy iterates K times over the entire dataset in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
+        fit(X,ids,iterations);
+    }
+
+    /**
+     * @brief Throws an exception when called. IVMGreedy does not support streaming!
+     * 
+     * @param x A constant reference to the next object on the stream.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> id = std::nullopt) {
+        throw std::runtime_error("IVMGreedy does not support streaming data, please use fit().");
+    }
+};
+
+#endif // IVM_GREEDY_H
@@ -0,0 +1,159 @@
+#ifndef LAZY_GREEDY_H
+#define LAZY_GREEDY_H
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <tuple>
+
+/**
+ * @brief  The LazyGreedy (or accelerated Greedy) optimizer for submodular functions. Due to submodularity, the marginal gain of an element can only shrink as the solution grows. Thus, the last known gain of an element is an upper bound on its current gain. LazyGreedy keeps all candidates in a max-heap keyed by their last known gain. In each round it re-evaluates the top element of the heap. If its fresh gain is still the largest in the heap, then no other element can be better and it is selected. Otherwise it is pushed back into the heap and the next top element is re-evaluated. For monotone submodular functions this selects the same solution as Greedy, but typically only a few elements are peeked per round:
+ *  - Stream:  No
+ *  - Solution: \f$ 1 - 1/\exp(1) \f$
+ *  - Runtime: \f$ O(N \cdot K) \f$ in the worst case, but usually much faster
+ *  - Memory: \f$ O(N) \f$
+ *  - Function Queries per Element: \f$ O(1) \f$
+ *  - Function Types: nonnegative, monotone submodular functions
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  //read some data
+ *  std::vector<std::vector<data_t>> = read_some_data();
+ *  auto K = 50;
+ *  // Define the function to be maximized and select the summary
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(data[0].size()), 1.0) , 1.0);
+ *  LazyGreedy opt(K, fastIVM);
+ *  opt.fit(data);
+ *  std::cout << "fval:" << opt.get_fval() << "num_elements: " << opt.get_num_elements_stored() << "num_candidates: " << opt.get_num_candidate_solutions() << std::endl;
+ *  // Process summary
+ *  auto summary = opt.get_solution();
+ * @endcode
+ *
+ * Example usage in Python:
+ * @code{.py}
+ *  X = read_some_data();
+ *  K = 50
+ *  # Create function to be maximized
+ *  kernel = RBFKernel(sigma=sigma,scale=scale)
+ *  fastLogDet = FastIVM(K, kernel, 1.0)
+ *  opt = LazyGreedy(K, fastLogDet)
+ *  opt.fit(X, K)
+ *  print("fval: {} num_elements: {} num_candidates: {}".format(opt.get_fval(), opt.get_num_elements_stored(), opt.get_num_candidate_solutions()))
+ *  # process summary
+ *  summary = opt.get_solution()
+ * @endcode
+ *
+ * __References__
+ *
+ * - Minoux, M. (1978). Accelerated greedy algorithms for maximizing submodular set functions. In J. Stoer (Ed.), Optimization Techniques (pp. 234–243). Springer Berlin Heidelberg. https://doi.org/10.1007/BFb0006528
+ */
+class LazyGreedy : public SubmodularOptimizer {
+public:
+
+    /**
+     * @brief Construct a new LazyGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
+     */
+    LazyGreedy(unsigned int K, SubmodularFunction & f) : SubmodularOptimizer(K,f) {}
+
+    /**
+     * @brief Construct a new LazyGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if `f` keeps track of a state.
+     */
+    LazyGreedy(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f) : SubmodularOptimizer(K,f) {}
+
+    /**
+     * @brief Runs LazyGreedy on the subset X[candidates[0]], X[candidates[1]], ... of the data set and stores the selected elements in the solution. This allows other optimizers (e.g. PartitionedGreedy) to run LazyGreedy on parts of the data without copying it.
+     *
+     * @param X A constant reference to the entire data set
+     * @param candidates The indices of the elements in X which should be considered
+     * @retval The indices of the selected elements in X in the order they were selected
+     */
+    std::vector<unsigned int> select(std::vector<std::vector<data_t>> const & X, std::vector<unsigned int> const & candidates) {
+        // Entries are (gain, -index, round in which the gain was computed). The negated index breaks ties towards the
+        // smaller index, so that we select the same elements as Greedy.
+        typedef std::tuple<data_t, long, unsigned int> entry;
+
+        // In the first round all gains are fresh, so we can peek all elements at once
+        std::vector<data_t> fvals;
+        f->peek_batch(solution, X, candidates, fvals);
+
+        std::vector<entry> entries(candidates.size());
+        for (unsigned int i = 0; i < candidates.size(); ++i) {
+            entries[i] = entry(fvals[i], -static_cast<long>(candidates[i]), 0);
+        }
+        std::priority_queue<entry> heap(std::less<entry>(), std::move(entries));
+
+        data_t fcur = 0;
+        std::vector<unsigned int> candidate(1);
+        std::vector<unsigned int> selected;
+        while(solution.size() < K && heap.size() > 0) {
+            auto [gain, neg_idx, round] = heap.top();
+            heap.pop();
+            unsigned int idx = static_cast<unsigned int>(-neg_idx);
+
+            if (round == solution.size()) {
+                // The gain is up-to-date and at-least as large as all (stale) upper bounds in the heap
+                f->update(solution, X[idx], solution.size());
+                solution.push_back(X[idx]);
+                selected.push_back(idx);
+                fcur += gain;
+            } else {
+                // We use peek_batch for a single candidate so that the function values are computed exactly as in Greedy
+                candidate[0] = idx;
+                f->peek_batch(solution, X, candidate, fvals);
+                heap.push(entry(fvals[0] - fcur, neg_idx, solution.size()));
+            }
+        }
+
+        fval = fcur;
+        is_fitted = true;
+        return selected;
+    }
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset, but only re-evaluate elements whose last known gain is the largest. Repeat this until K element have been selected. You can access the solution via `get_solution` and the corresponding ids (if passed) with `get_ids()`
+     *
+     * @param X A constant reference to the entire data set
+     * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.
+     * @param iterations: Has no effect. LazyGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
+        std::vector<unsigned int> all(X.size());
+        std::iota(all.begin(), all.end(), 0);
+
+        for (auto idx : select(X, all)) {
+            if (idx < ids.size()) {
+                this->ids.push_back(ids[idx]);
+            }
+        }
+    }
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset. Repeat this until K element have been selected. You can access the solution via `get_solution`
+     * @note This internally calls fit with an empty id set.
+     * @param X A constant reference to the entire data set
+     * @param iterations: Has no effect. LazyGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
+        fit(X,ids,iterations);
+    }
+
+    /**
+     * @brief Throws an exception when called. LazyGreedy does not support streaming!
+     *
+     * @param x A constant reference to the next object on the stream.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> id = std::nullopt) {
+        throw std::runtime_error("LazyGreedy does not support streaming data, please use fit().");
+    }
+};
+
+#endif // LAZY_GREEDY_H
@@ -0,0 +1,188 @@
+#ifndef PARALLEL_GREEDY_H
+#define PARALLEL_GREEDY_H
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <numeric>
+
+/**
+ * @brief  A multi-threaded version of the Greedy optimizer. In each round, the remaining candidates are split into one contiguous chunk per thread and each thread rates its chunk with its own clone of the submodular function (see SubmodularFunction::clone). The selected element is then broadcast to all clones via `update`. Ties are broken towards the smaller index, so that the solution is identical to Greedy:
+ *  - Stream:  No
+ *  - Solution: \f$ 1 - 1/\exp(1) \f$
+ *  - Runtime: \f$ O(N \cdot K / T) \f$ where T is the number of threads
+ *  - Memory: \f$ O(T \cdot K) \f$
+ *  - Function Queries per Element: \f$ O(1) \f$
+ *  - Function Types: nonnegative submodular functions
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  //read some data
+ *  std::vector<std::vector<data_t>> = read_some_data();
+ *  auto K = 50;
+ *  // Define the function to be maximized and select the summary
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(data[0].size()), 1.0) , 1.0);
+ *  ParallelGreedy opt(K, fastIVM, 8);
+ *  opt.fit(data);
+ *  std::cout << "fval:" << opt.get_fval() << "num_elements: " << opt.get_num_elements_stored() << "num_candidates: " << opt.get_num_candidate_solutions() << std::endl;
+ *  // Process summary
+ *  auto summary = opt.get_solution();
+ * @endcode
+ *
+ * Example usage in Python:
+ * @code{.py}
+ *  X = read_some_data();
+ *  K = 50
+ *  # Create function to be maximized
+ *  kernel = RBFKernel(sigma=sigma,scale=scale)
+ *  fastLogDet = FastIVM(K, kernel, 1.0)
+ *  opt = ParallelGreedy(K, fastLogDet, 8)
+ *  opt.fit(X, K)
+ *  print("fval: {} num_elements: {} num_candidates: {}".format(opt.get_fval(), opt.get_num_elements_stored(), opt.get_num_candidate_solutions()))
+ *  # process summary
+ *  summary = opt.get_solution()
+ * @endcode
+ *
+ * __References__
+ *
+ * - Nemhauser, G. L., Wolsey, L. A., & Fisher, M. L. (1978). An analysis of approximations for maximizing submodular set functions-I. Mathematical Programming, 14(1), 265–294. https://doi.org/10.1007/BF01588971
+ */
+class ParallelGreedy : public SubmodularOptimizer {
+protected:
+    // The threads
+    ThreadPool pool;
+
+    // One function per thread. The first one is f itself, all others are clones of f.
+    std::vector<std::shared_ptr<SubmodularFunction>> fs;
+
+    /**
+     * @brief  Clones the function for each thread.
+     */
+    void init() {
+        fs.push_back(f);
+        for (unsigned int t = 1; t < pool.size(); ++t) {
+            fs.push_back(f->clone());
+        }
+    }
+
+public:
+
+    /**
+     * @brief Construct a new ParallelGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction for every thread which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
+     * @param num_threads The number of threads. If this is 0, then one thread per core is used.
+     */
+    ParallelGreedy(unsigned int K, SubmodularFunction & f, unsigned int num_threads = 0) : SubmodularOptimizer(K,f), pool(num_threads) {
+        init();
+    }
+
+    /**
+     * @brief Construct a new ParallelGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, all threads reference the __same__ function which must be thread-safe. This can be very efficient for state-less functions, but may lead to weird side effects if `f` keeps track of a state.
+     * @param num_threads The number of threads. If this is 0, then one thread per core is used.
+     */
+    ParallelGreedy(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, unsigned int num_threads = 0) : SubmodularOptimizer(K,f), pool(num_threads) {
+        init();
+    }
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset, where the candidates are rated in parallel. Repeat this until K element have been selected. You can access the solution via `get_solution` and the corresponding ids (if passed) with `get_ids()`
+     *
+     * @param X A constant reference to the entire data set
+     * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.
+     * @param iterations: Has no effect. ParallelGreedy iterates K times over the entire dataset in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
+        unsigned int T = pool.size();
+        std::vector<unsigned int> remaining(X.size());
+        std::iota(remaining.begin(), remaining.end(), 0);
+
+        // Scratch space for each thread: its chunk of candidates, their function values and the position of the best one in remaining
+        std::vector<std::vector<unsigned int>> chunks(T);
+        std::vector<std::vector<data_t>> fvals(T);
+        std::vector<unsigned int> best(T);
+
+        data_t fcur = 0;
+        while(solution.size() < K && remaining.size() > 0) {
+            pool.run([&](unsigned int t) {
+                unsigned int begin = remaining.size() * t / T;
+                unsigned int end = remaining.size() * (t + 1) / T;
+                chunks[t].assign(remaining.begin() + begin, remaining.begin() + end);
+                if (chunks[t].size() == 0) {
+                    return;
+                }
+
+                fs[t]->peek_batch(solution, X, chunks[t], fvals[t]);
+                unsigned int b = 0;
+                for (unsigned int i = 1; i < chunks[t].size(); ++i) {
+                    if (fvals[t][i] > fvals[t][b] || (fvals[t][i] == fvals[t][b] && chunks[t][i] < chunks[t][b])) {
+                        b = i;
+                    }
+                }
+                best[t] = b;
+            });
+
+            // Ties are broken towards the smaller index as in Greedy
+            unsigned int max_t = T;
+            for (unsigned int t = 0; t < T; ++t) {
+                if (chunks[t].size() == 0) {
+                    continue;
+                }
+                if (max_t == T) {
+                    max_t = t;
+                    continue;
+                }
+                data_t cur = fvals[t][best[t]], max = fvals[max_t][best[max_t]];
+                if (cur > max || (cur == max && chunks[t][best[t]] < chunks[max_t][best[max_t]])) {
+                    max_t = t;
+                }
+            }
+            fcur = fvals[max_t][best[max_t]];
+            unsigned int max_idx = chunks[max_t][best[max_t]];
+
+            // Broadcast the selected element to all functions
+            pool.run([&](unsigned int t) {
+                fs[t]->update(solution, X[max_idx], solution.size());
+            });
+            solution.push_back(X[max_idx]);
+            if (max_idx < ids.size()) {
+                this->ids.push_back(ids[max_idx]);
+            }
+
+            // The order of the remaining elements does not matter, hence we remove the selected one in O(1)
+            unsigned int pos = remaining.size() * max_t / T + best[max_t];
+            remaining[pos] = remaining.back();
+            remaining.pop_back();
+        }
+
+        fval = fcur;
+        is_fitted = true;
+    }
+
+    /**
+     * @brief Pick that element with the largest marginal gain in the entire dataset, where the candidates are rated in parallel. Repeat this until K element have been selected. You can access the solution via `get_solution`
+     * @note This internally calls fit with an empty id set.
+     * @param X A constant reference to the entire data set
+     * @param iterations: Has no effect. ParallelGreedy iterates K times over the entire dataset in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
+        fit(X,ids,iterations);
+    }
+
+    /**
+     * @brief Throws an exception when called. ParallelGreedy does not support streaming!
+     *
+     * @param x A constant reference to the next object on the stream.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> id = std::nullopt) {
+        throw std::runtime_error("ParallelGreedy does not support streaming data, please use fit().");
+    }
+};
+
+#endif // PARALLEL_GREEDY_H
@@ -0,0 +1,178 @@
+#ifndef PARTITIONED_GREEDY_H
+#define PARTITIONED_GREEDY_H
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include "LazyGreedy.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+/**
+ * @brief  The two-round GreeDi optimizer for very large batches. The data set is randomly partitioned into P shards and LazyGreedy is run independently on each shard (in parallel on a ThreadPool with its own clone of the submodular function). Then, LazyGreedy is run a second time on the union of the (at most) P * K elements selected in the shards. The best solution among the final solution and the P shard solutions is returned. Barbosa et al. showed, that for a random partition this gives a \f$ (1 - 1/\exp(1)) / 2 \f$ approximation in expectation. Since each shard only contains N / P elements, the first round scales (almost) linearly with the number of threads:
+ *  - Stream:  No
+ *  - Solution: \f$ (1 - 1/\exp(1)) / 2 \f$ in expectation
+ *  - Runtime: \f$ O(N \cdot K / T + P \cdot K^2) \f$ where T is the number of threads
+ *  - Memory: \f$ O(N + P \cdot K) \f$
+ *  - Function Queries per Element: \f$ O(1) \f$
+ *  - Function Types: nonnegative, monotone submodular functions
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  //read some data
+ *  std::vector<std::vector<data_t>> = read_some_data();
+ *  auto K = 50;
+ *  // Define the function to be maximized and select the summary
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(data[0].size()), 1.0) , 1.0);
+ *  PartitionedGreedy opt(K, fastIVM, 16, 8);
+ *  opt.fit(data);
+ *  std::cout << "fval:" << opt.get_fval() << "num_elements: " << opt.get_num_elements_stored() << "num_candidates: " << opt.get_num_candidate_solutions() << std::endl;
+ *  // Process summary
+ *  auto summary = opt.get_solution();
+ * @endcode
+ *
+ * Example usage in Python:
+ * @code{.py}
+ *  X = read_some_data();
+ *  K = 50
+ *  # Create function to be maximized
+ *  kernel = RBFKernel(sigma=sigma,scale=scale)
+ *  fastLogDet = FastIVM(K, kernel, 1.0)
+ *  opt = PartitionedGreedy(K, fastLogDet, 16, 8)
+ *  opt.fit(X, K)
+ *  print("fval: {} num_elements: {} num_candidates: {}".format(opt.get_fval(), opt.get_num_elements_stored(), opt.get_num_candidate_solutions()))
+ *  # process summary
+ *  summary = opt.get_solution()
+ * @endcode
+ *
+ * __References__
+ *
+ * - Mirzasoleiman, B., Karbasi, A., Sarkar, R., & Krause, A. (2013). Distributed Submodular Maximization: Identifying Representative Elements in Massive Data. In Advances in Neural Information Processing Systems 26 (pp. 2049–2057).
+ * - Barbosa, R. da P., Ene, A., Nguyen, H. L., & Ward, J. (2015). The Power of Randomization: Distributed Submodular Maximization on Massive Datasets. In Proceedings of the 32nd International Conference on Machine Learning (pp. 1236–1244).
+ */
+class PartitionedGreedy : public SubmodularOptimizer {
+protected:
+    // The number of shards
+    unsigned int num_partitions;
+
+    // The threads
+    ThreadPool pool;
+
+    std::default_random_engine generator;
+
+public:
+
+    /**
+     * @brief Construct a new PartitionedGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction for every shard which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
+     * @param num_partitions The number of shards. If this is 0, then one shard per thread is used.
+     * @param num_threads The number of threads. If this is 0, then one thread per core is used.
+     * @param seed The random seed used for partitioning the data.
+     */
+    PartitionedGreedy(unsigned int K, SubmodularFunction & f, unsigned int num_partitions = 0, unsigned int num_threads = 0, unsigned long seed = 0) : SubmodularOptimizer(K,f), num_partitions(num_partitions), pool(num_threads), generator(seed) {
+        if (this->num_partitions == 0) {
+            this->num_partitions = pool.size();
+        }
+    }
+
+    /**
+     * @brief Construct a new PartitionedGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, all threads reference the __same__ function which must be thread-safe. This can be very efficient for state-less functions, but may lead to weird side effects if `f` keeps track of a state.
+     * @param num_partitions The number of shards. If this is 0, then one shard per thread is used.
+     * @param num_threads The number of threads. If this is 0, then one thread per core is used.
+     * @param seed The random seed used for partitioning the data.
+     */
+    PartitionedGreedy(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, unsigned int num_partitions = 0, unsigned int num_threads = 0, unsigned long seed = 0) : SubmodularOptimizer(K,f), num_partitions(num_partitions), pool(num_threads), generator(seed) {
+        if (this->num_partitions == 0) {
+            this->num_partitions = pool.size();
+        }
+    }
+
+    /**
+     * @brief Randomly partition the data set into shards, run LazyGreedy on each shard in parallel and then run LazyGreedy once more on the union of the shard solutions. The best of these solutions is kept. You can access the solution via `get_solution` and the corresponding ids (if passed) with `get_ids()`
+     *
+     * @param X A constant reference to the entire data set
+     * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.
+     * @param iterations: Has no effect. PartitionedGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
+        unsigned int P = num_partitions;
+        unsigned int T = pool.size();
+
+        // Randomly assign the elements to the shards. The shards are only lists of indices, so that the data is not copied.
+        std::vector<unsigned int> perm(X.size());
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), generator);
+
+        std::vector<std::vector<unsigned int>> shards(P);
+        for (unsigned int i = 0; i < perm.size(); ++i) {
+            shards[i % P].push_back(perm[i]);
+        }
+
+        // One LazyGreedy per shard and one for the union of all shard solutions
+        std::vector<std::unique_ptr<LazyGreedy>> opts(P + 1);
+        std::vector<std::vector<unsigned int>> selected(P + 1);
+        pool.run([&](unsigned int t) {
+            for (unsigned int p = t; p < P; p += T) {
+                // Sort each shard so that ties are broken towards the smaller index as in Greedy
+                std::sort(shards[p].begin(), shards[p].end());
+                opts[p] = std::make_unique<LazyGreedy>(K, *f);
+                selected[p] = opts[p]->select(X, shards[p]);
+            }
+        });
+
+        std::vector<unsigned int> merged;
+        for (unsigned int p = 0; p < P; ++p) {
+            merged.insert(merged.end(), selected[p].begin(), selected[p].end());
+        }
+        std::sort(merged.begin(), merged.end());
+
+        opts[P] = std::make_unique<LazyGreedy>(K, *f);
+        selected[P] = opts[P]->select(X, merged);
+
+        // Prefer the final solution in case of a tie
+        unsigned int best = P;
+        for (unsigned int p = 0; p < P; ++p) {
+            if (opts[p]->get_fval() > opts[best]->get_fval()) {
+                best = p;
+            }
+        }
+
+        solution = opts[best]->get_solution();
+        for (auto idx : selected[best]) {
+            if (idx < ids.size()) {
+                this->ids.push_back(ids[idx]);
+            }
+        }
+
+        fval = opts[best]->get_fval();
+        is_fitted = true;
+    }
+
+    /**
+     * @brief Randomly partition the data set into shards, run LazyGreedy on each shard in parallel and then run LazyGreedy once more on the union of the shard solutions. The best of these solutions is kept. You can access the solution via `get_solution`
+     * @note This internally calls fit with an empty id set.
+     * @param X A constant reference to the entire data set
+     * @param iterations: Has no effect. PartitionedGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
+        fit(X,ids,iterations);
+    }
+
+    /**
+     * @brief Throws an exception when called. PartitionedGreedy does not support streaming!
+     *
+     * @param x A constant reference to the next object on the stream.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> id = std::nullopt) {
+        throw std::runtime_error("PartitionedGreedy does not support streaming data, please use fit().");
+    }
+};
+
+#endif // PARTITIONED_GREEDY_H
@@ -10,6 +10,11 @@
 #include "functions/IVM.h"
 #include "functions/FastIVM.h"
 #include "Greedy.h"
+#include "IVMGreedy.h"
+#include "LazyGreedy.h"
+#include "StochasticGreedy.h"
+#include "ParallelGreedy.h"
+#include "PartitionedGreedy.h"
 #include "Random.h"
 #include "SieveStreaming.h"
 #include "SieveStreamingPP.h"
@@ -19,6 +24,15 @@
 
 namespace py = pybind11;
 
+/**
+ * @brief  Deleter for python objects which are kept alive by a shared_ptr on the C++ side. The last reference might be dropped while the GIL is released (e.g. during fit / next), thus we need to re-acquire it before touching the reference count.
+ * @param  obj: The python object to be deleted.
+ */
+inline void gil_safe_delete(py::object * obj) {
+    py::gil_scoped_acquire acquire;
+    delete obj;
+}
+
 /**
  * @brief  This is a wrapper / trampoline class to pass the SubmodularFunction interface to the Python-side of things.  
  */
@@ -56,15 +70,27 @@ public:
        );
     }
 
+    void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) override {
+        PYBIND11_OVERRIDE(
+           void,
+           SubmodularFunction,
+           remove,
+           cur_solution, 
+           pos
+       );
+    }
+
     ~PySubmodularFunction() {
     }
 
     // See https://github.com/pybind/pybind11/issues/1049
     std::shared_ptr<SubmodularFunction> clone() const override {
+        // The optimizers release the GIL during fit / next, but may clone functions on-the-fly (e.g. SieveStreamingPP)
+        py::gil_scoped_acquire acquire;
         auto self = py::cast(this);
         auto cloned = self.attr("clone")();
 
-        auto keep_python_state_alive = std::make_shared<py::object>(cloned);
+        auto keep_python_state_alive = std::shared_ptr<py::object>(new py::object(cloned), gil_safe_delete);
         auto ptr = cloned.cast<PySubmodularFunction*>();
 
         std::shared_ptr<SubmodularFunction> newobj = std::shared_ptr<SubmodularFunction>(keep_python_state_alive, ptr);
@@ -94,10 +120,11 @@ public:
 
     // See https://github.com/pybind/pybind11/issues/1049
     std::shared_ptr<Kernel> clone() const override {
+        py::gil_scoped_acquire acquire;
         auto self = py::cast(this);
         auto cloned = self.attr("clone")();
 
-        auto keep_python_state_alive = std::make_shared<py::object>(cloned);
+        auto keep_python_state_alive = std::shared_ptr<py::object>(new py::object(cloned), gil_safe_delete);
         auto ptr = cloned.cast<PyKernel*>();
 
         std::shared_ptr<Kernel> newobj = std::shared_ptr<Kernel>(keep_python_state_alive, ptr);
@@ -123,18 +150,37 @@ PYBIND11_MODULE(PySSM, m) {
         .def("__call__", &RBFKernel::operator())
         .def("clone", &RBFKernel::clone, py::return_value_policy::reference);
 
+    py::class_<NativeKernel, Kernel, std::shared_ptr<NativeKernel>>(m, "NativeKernel")
+        .def(py::init([](std::uintptr_t address) {
+            return std::make_shared<NativeKernel>(reinterpret_cast<NativeKernel::kernel_ptr>(address));
+        }), py::arg("address"))
+        .def("__call__", &NativeKernel::operator())
+        .def("clone", &NativeKernel::clone, py::return_value_policy::reference);
+
     py::class_<SubmodularFunction, PySubmodularFunction, std::shared_ptr<SubmodularFunction>>(m, "SubmodularFunction")
         .def(py::init<>())
         .def("peek", &SubmodularFunction::peek, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
         .def("update", &SubmodularFunction::update, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
+        .def("remove", &SubmodularFunction::remove, py::arg("cur_solution"), py::arg("pos"))
         .def("__call__", &SubmodularFunction::operator())
         .def("clone", &SubmodularFunction::clone, py::return_value_policy::reference);
 
+    py::class_<NativeSubmodularFunction, SubmodularFunction, std::shared_ptr<NativeSubmodularFunction>>(m, "NativeSubmodularFunction")
+        .def(py::init([](std::uintptr_t address) {
+            return std::make_shared<NativeSubmodularFunction>(reinterpret_cast<NativeSubmodularFunction::function_ptr>(address));
+        }), py::arg("address"))
+        .def("peek", &NativeSubmodularFunction::peek, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
+        .def("update", &NativeSubmodularFunction::update, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
+        .def("remove", &NativeSubmodularFunction::remove, py::arg("cur_solution"), py::arg("pos"))
+        .def("__call__", &NativeSubmodularFunction::operator())
+        .def("clone", &NativeSubmodularFunction::clone, py::return_value_policy::reference);
+
     py::class_<IVM, SubmodularFunction, std::shared_ptr<IVM> >(m, "IVM")
         .def(py::init<std::function<data_t (std::vector<data_t> const &, std::vector<data_t> const &)>, data_t>(), py::arg("kernel"), py::arg("sigma"))
         .def(py::init<Kernel const &, data_t>(), py::arg("kernel"), py::arg("sigma") = 1.0)
         .def("peek", &IVM::peek, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
         .def("update", &IVM::update, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
+        .def("remove", &IVM::remove, py::arg("cur_solution"), py::arg("pos"))
         .def("__call__", &IVM::operator())
         .def("clone", &IVM::clone, py::return_value_policy::reference);
 
@@ -143,6 +189,7 @@ PYBIND11_MODULE(PySSM, m) {
         .def(py::init<unsigned int, Kernel const &, data_t>(),  py::arg("K"),  py::arg("kernel"), py::arg("sigma") = 1.0)
         .def("peek", &FastIVM::peek, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
         .def("update", &FastIVM::update, py::arg("cur_solution"), py::arg("x"), py::arg("pos"))
+        .def("remove", &FastIVM::remove, py::arg("cur_solution"), py::arg("pos"))
         .def("__call__", &FastIVM::operator())
         .def("clone", &FastIVM::clone, py::return_value_policy::reference);
 
@@ -155,9 +202,64 @@ PYBIND11_MODULE(PySSM, m) {
         .def("get_fval", &Greedy::get_fval)
         .def("get_num_candidate_solutions", &Greedy::get_num_candidate_solutions)
         .def("get_num_elements_stored", &Greedy::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Greedy::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Greedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1);
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Greedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Greedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
+    
+    py::class_<LazyGreedy>(m, "LazyGreedy") 
+        .def(py::init<unsigned int, SubmodularFunction&>(), py::arg("K"), py::arg("f"))
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)> >(), py::arg("K"), py::arg("f"))
+        .def("get_solution", &LazyGreedy::get_solution)
+        .def("get_ids", &LazyGreedy::get_ids)
+        .def("get_fval", &LazyGreedy::get_fval)
+        .def("get_num_candidate_solutions", &LazyGreedy::get_num_candidate_solutions)
+        .def("get_num_elements_stored", &LazyGreedy::get_num_elements_stored)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&LazyGreedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&LazyGreedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
+    
+    py::class_<StochasticGreedy>(m, "StochasticGreedy") 
+        .def(py::init<unsigned int, SubmodularFunction&, data_t, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("epsilon"), py::arg("seed") = 0)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("epsilon"), py::arg("seed") = 0)
+        .def("get_solution", &StochasticGreedy::get_solution)
+        .def("get_ids", &StochasticGreedy::get_ids)
+        .def("get_fval", &StochasticGreedy::get_fval)
+        .def("get_num_candidate_solutions", &StochasticGreedy::get_num_candidate_solutions)
+        .def("get_num_elements_stored", &StochasticGreedy::get_num_elements_stored)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&StochasticGreedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&StochasticGreedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
+    
+    py::class_<ParallelGreedy>(m, "ParallelGreedy") 
+        .def(py::init<unsigned int, SubmodularFunction&, unsigned int>(), py::arg("K"), py::arg("f"), py::arg("num_threads") = 0)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, unsigned int>(), py::arg("K"), py::arg("f"), py::arg("num_threads") = 0)
+        .def("get_solution", &ParallelGreedy::get_solution)
+        .def("get_ids", &ParallelGreedy::get_ids)
+        .def("get_fval", &ParallelGreedy::get_fval)
+        .def("get_num_candidate_solutions", &ParallelGreedy::get_num_candidate_solutions)
+        .def("get_num_elements_stored", &ParallelGreedy::get_num_elements_stored)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&ParallelGreedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&ParallelGreedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
     
+    py::class_<PartitionedGreedy>(m, "PartitionedGreedy") 
+        .def(py::init<unsigned int, SubmodularFunction&, unsigned int, unsigned int, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("num_partitions") = 0, py::arg("num_threads") = 0, py::arg("seed") = 0)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, unsigned int, unsigned int, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("num_partitions") = 0, py::arg("num_threads") = 0, py::arg("seed") = 0)
+        .def("get_solution", &PartitionedGreedy::get_solution)
+        .def("get_ids", &PartitionedGreedy::get_ids)
+        .def("get_fval", &PartitionedGreedy::get_fval)
+        .def("get_num_candidate_solutions", &PartitionedGreedy::get_num_candidate_solutions)
+        .def("get_num_elements_stored", &PartitionedGreedy::get_num_elements_stored)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&PartitionedGreedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&PartitionedGreedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
+    
+    py::class_<IVMGreedy>(m, "IVMGreedy") 
+        .def(py::init<unsigned int, IVM&>(), py::arg("K"), py::arg("f"))
+        .def(py::init<unsigned int, std::function<data_t (std::vector<data_t> const &, std::vector<data_t> const &)>, data_t>(), py::arg("K"), py::arg("kernel"), py::arg("sigma") = 1.0)
+        .def("get_solution", &IVMGreedy::get_solution)
+        .def("get_ids", &IVMGreedy::get_ids)
+        .def("get_fval", &IVMGreedy::get_fval)
+        .def("get_num_candidate_solutions", &IVMGreedy::get_num_candidate_solutions)
+        .def("get_num_elements_stored", &IVMGreedy::get_num_elements_stored)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&IVMGreedy::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&IVMGreedy::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>());
+
     py::class_<Random>(m, "Random") 
         .def(py::init<unsigned int, SubmodularFunction&, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("seed")= 0)
         .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("seed") = 0)
@@ -166,9 +268,10 @@ PYBIND11_MODULE(PySSM, m) {
         .def("get_fval", &Random::get_fval)
         .def("get_num_candidate_solutions", &Random::get_num_candidate_solutions)
         .def("get_num_elements_stored", &Random::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Random::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Random::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1)
-        .def("next", &Random::next, py::arg("x"), py::arg("id") = std::nullopt);
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Random::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Random::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &Random::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &Random::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
 
     py::class_<IndependentSetImprovement>(m, "IndependentSetImprovement") 
         .def(py::init<unsigned int, SubmodularFunction&>(), py::arg("K"), py::arg("f"))
@@ -178,33 +281,37 @@ PYBIND11_MODULE(PySSM, m) {
         .def("get_fval", &IndependentSetImprovement::get_fval)
         .def("get_num_candidate_solutions", &IndependentSetImprovement::get_num_candidate_solutions)
         .def("get_num_elements_stored", &IndependentSetImprovement::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&IndependentSetImprovement::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&IndependentSetImprovement::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1)
-        .def("next", &IndependentSetImprovement::next, py::arg("x"), py::arg("id") = std::nullopt);
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&IndependentSetImprovement::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&IndependentSetImprovement::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &IndependentSetImprovement::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &IndependentSetImprovement::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
 
     py::class_<SieveStreaming>(m, "SieveStreaming") 
-        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"))
-        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t>(), py::arg("K"), py::arg("f"),  py::arg("m"), py::arg("epsilon"))
+        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t, unsigned int>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("num_threads") = 1)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t, unsigned int>(), py::arg("K"), py::arg("f"),  py::arg("m"), py::arg("epsilon"), py::arg("num_threads") = 1)
         .def("get_solution", &SieveStreaming::get_solution)
         .def("get_ids", &SieveStreaming::get_ids)
         .def("get_fval", &SieveStreaming::get_fval)
         .def("get_num_candidate_solutions", &SieveStreaming::get_num_candidate_solutions)
         .def("get_num_elements_stored", &SieveStreaming::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&SieveStreaming::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&SieveStreaming::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1)
-        .def("next", &SieveStreaming::next, py::arg("x"), py::arg("id") = std::nullopt);
+        .def("get_num_retired_sieves", &SieveStreaming::get_num_retired_sieves)
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&SieveStreaming::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&SieveStreaming::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &SieveStreaming::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &SieveStreaming::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
     
     py::class_<SieveStreamingPP>(m, "SieveStreamingPP") 
-        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"))
-        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t>(), py::arg("K"), py::arg("f"),  py::arg("m"), py::arg("epsilon"))
+        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t, unsigned int>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("num_threads") = 1)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t, unsigned int>(), py::arg("K"), py::arg("f"),  py::arg("m"), py::arg("epsilon"), py::arg("num_threads") = 1)
         .def("get_solution", &SieveStreamingPP::get_solution)
         .def("get_ids", &SieveStreamingPP::get_ids)
         .def("get_fval", &SieveStreamingPP::get_fval)
         .def("get_num_candidate_solutions", &SieveStreamingPP::get_num_candidate_solutions)
         .def("get_num_elements_stored", &SieveStreamingPP::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&SieveStreamingPP::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&SieveStreamingPP::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1)
-        .def("next", &SieveStreamingPP::next, py::arg("x"), py::arg("id") = std::nullopt);
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&SieveStreamingPP::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&SieveStreamingPP::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &SieveStreamingPP::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &SieveStreamingPP::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
     
     py::class_<ThreeSieves>(m, "ThreeSieves") 
         .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t, std::string const &, unsigned int>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("strategy"), py::arg("T"))
@@ -214,18 +321,21 @@ PYBIND11_MODULE(PySSM, m) {
         .def("get_fval", &ThreeSieves::get_fval)
         .def("get_num_candidate_solutions", &ThreeSieves::get_num_candidate_solutions)
         .def("get_num_elements_stored", &ThreeSieves::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&ThreeSieves::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&ThreeSieves::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1)
-        .def("next", &ThreeSieves::next, py::arg("x"), py::arg("id") = std::nullopt);
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&ThreeSieves::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&ThreeSieves::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &ThreeSieves::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &ThreeSieves::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
 
     py::class_<Salsa>(m, "Salsa") 
-        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t, data_t, data_t, data_t, data_t, data_t, data_t,data_t>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("hilow_epsilon") = 0.05, py::arg("hilow_beta") = 0.1, py::arg("hilow_delta") = 0.025, py::arg("dense_beta") = 0.8, py::arg("dense_C1") = 10, py::arg("dense_C2") = 0.2, py::arg("fixed_epsilon") = 1.0/6.0)
-        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t, data_t, data_t, data_t, data_t, data_t, data_t,data_t>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("hilow_epsilon") = 0.05, py::arg("hilow_beta") = 0.1, py::arg("hilow_delta") = 0.025, py::arg("dense_beta") = 0.8, py::arg("dense_C1") = 10, py::arg("dense_C2") = 0.2, py::arg("fixed_epsilon") = 1.0/6.0)
+        .def(py::init<unsigned int, SubmodularFunction&, data_t, data_t, data_t, data_t, data_t, data_t, data_t, data_t,data_t, unsigned int, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("hilow_epsilon") = 0.05, py::arg("hilow_beta") = 0.1, py::arg("hilow_delta") = 0.025, py::arg("dense_beta") = 0.8, py::arg("dense_C1") = 10, py::arg("dense_C2") = 0.2, py::arg("fixed_epsilon") = 1.0/6.0, py::arg("num_threads") = 1, py::arg("N") = 0)
+        .def(py::init<unsigned int, std::function<data_t (std::vector<std::vector<data_t>> const &)>, data_t, data_t, data_t, data_t, data_t, data_t, data_t, data_t,data_t, unsigned int, unsigned long>(), py::arg("K"), py::arg("f"), py::arg("m"), py::arg("epsilon"), py::arg("hilow_epsilon") = 0.05, py::arg("hilow_beta") = 0.1, py::arg("hilow_delta") = 0.025, py::arg("dense_beta") = 0.8, py::arg("dense_C1") = 10, py::arg("dense_C2") = 0.2, py::arg("fixed_epsilon") = 1.0/6.0, py::arg("num_threads") = 1, py::arg("N") = 0)
         .def("get_solution", &Salsa::get_solution)
         .def("get_ids", &Salsa::get_ids)
         .def("get_fval", &Salsa::get_fval)
         .def("get_num_candidate_solutions", &Salsa::get_num_candidate_solutions)
         .def("get_num_elements_stored", &Salsa::get_num_elements_stored)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Salsa::fit), py::arg("X"), py::arg("iterations") = 1)
-        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Salsa::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1); 
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, unsigned int>(&Salsa::fit), py::arg("X"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("fit", py::overload_cast<std::vector<std::vector<data_t>> const &, std::vector<idx_t> const &, unsigned int>(&Salsa::fit), py::arg("X"), py::arg("ids"), py::arg("iterations") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("next", &Salsa::next, py::arg("x"), py::arg("id") = std::nullopt, py::call_guard<py::gil_scoped_release>())
+        .def("next_batch", &Salsa::next_batch, py::arg("X"), py::arg("ids") = std::vector<idx_t>(), py::call_guard<py::gil_scoped_release>());
 }
@@ -4,13 +4,16 @@
 #include "DataTypeHandling.h"
 #include "SubmodularOptimizer.h"
 #include "SieveStreaming.h"
+#include "SieveBank.h"
+#include "ThreadPool.h"
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <unordered_set>
 
 /**
- * @brief  The Salsa optimizer for submodular functions. This algorithms runs multiple copies of different thresholding strategies in parallel. Some of these strategies require additional information about the datastream such as its length and thus this algorithm might not be applicable in a "real" streaming scenario
+ * @brief  The Salsa optimizer for submodular functions. This algorithms runs multiple copies of different thresholding strategies in parallel. Strategies which accepted the same items so far share their summary, their function state and a single peek per item and only fork once they diverge (similar to the groups of SieveStreaming). Some of these strategies require additional information about the datastream such as its length. `fit` uses the size of the data set, whereas `next` uses an estimate of the length given in the constructor or - if no estimate is given - a doubling schedule which starts with K and doubles the estimate whenever the stream gets longer.
  *  - Stream:  (Yes)
  *  - Solution: \f$1/2 - \varepsilon\f$
  *  - Runtime: \f$O(1)\f$
@@ -55,265 +58,15 @@ class Salsa : public SubmodularOptimizer {
 protected:
 
     /**
-     * @brief  Fixed thresholding strategy (Algorithm 2 in the ICML paper). This basically simulates the thresholding strategy of SieveStreaming with a slightly different sampling strategy for the thresholds. In the original version OPT is known and different epsilon are used to "sample" different thresholds. As detailed in the longer version arxiv of the paper, we can estimate OPT via \f$O = \{(1+\varepsilon)^i \mid i \in \mathbb{Z}, m \le (1+\varepsilon)^i \le K \cdot m\}\f$ where \f$ m = \max f({m}) \f$ is the maximum singleton function value. 
-     * @note   This class is basically also implemented in SieveStreaming and SieveStreamingPP. I decided against a unified class for these Sieves, since the thresholding rules are often slightly different from paper to paper. I tried to stick as close as possible to the pseudocode in the papers.
+     * @brief  The thresholding strategies of Salsa. In the original version OPT is known and different epsilon are used to "sample" different thresholds. As detailed in the longer arxiv version of the paper, we can estimate OPT via \f$O = \{(1+\varepsilon)^i \mid i \in \mathbb{Z}, m \le (1+\varepsilon)^i \le K \cdot m\}\f$ where \f$ m = \max f({m}) \f$ is the maximum singleton function value. Each strategy is run for each sampled threshold.
+     *  - Fixed: Fixed thresholding strategy (Algorithm 2 in the ICML paper). This basically simulates the thresholding strategy of SieveStreaming with a slightly different sampling strategy for the thresholds.
+     *  - HighLow: High-Low thresholding strategy (Algorithm 3 in in the ICML paper). This basically combines Dense and Fixed: It uses a high threshold for the first \f$\beta \cdot N\f$ items and a low threshold afterwards.
+     *  - Dense: Dense thresholding strategy (Algorithm 1 in the ICML paper). This basically simulates the SimpleGreedy / PreemptionStreaming algorithm with a slightly different sampling strategy for the thresholds. It uses the threshold \f$C_1 \cdot v / K\f$ for the first \f$\beta \cdot N\f$ items and \f$v / (C_2 \cdot K)\f$ afterwards.
      */
-    class FixedThreshold : public SubmodularOptimizer {
-    private:
-
-        // Epsilon parameter
-        data_t epsilon;
-
-        // Sampled OPT threshold 
-        data_t threshold;
-
-    public:
-
-        /**
-         * @brief Construct a new FixedThreshold object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
-         * @param epsilon The epsilon parameter for this algorithm
-         * @param threshold The (sampled) OPT threshold  
-         */
-        FixedThreshold(unsigned int K, SubmodularFunction & f, data_t epsilon, data_t threshold) 
-            : SubmodularOptimizer(K,f), epsilon(epsilon), threshold(threshold) {}
-
-
-        /**
-         * @brief Construct a new FixedThreshold object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state.
-         * @param epsilon The epsilon parameter for this algorithm
-         * @param threshold The (sampled) OPT threshold
-         */
-        FixedThreshold(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t epsilon, data_t threshold) 
-            : SubmodularOptimizer(K,f),  epsilon(epsilon), threshold(threshold) {}
-
-        /**
-         * @brief Throws an exception when called. FixedThreshold should not be used outside Salsa.
-         * 
-         * @param X A constant reference to the entire data set
-         * @param iterations: Number of iterations over the entire dataset
-         */
-        void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
-            throw std::runtime_error("FixedThresholds are only meant to be used through Salsa and therefore do not require the implementation of `fit'");
-        }
-
-        /**
-         * @brief  Consume the next object in the data stream. Add the current item to the summary if there are fewer than K element in it and if the items gain exceeds the current thresholding rule. Performs one function query.
-         * 
-         * @param  &x: A constant reference to the next object on the stream.
-         * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
-         */
-        void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-            unsigned int Kcur = solution.size();
-            if (Kcur < K) {
-                data_t fdelta = f->peek(solution, x, solution.size()) - fval;
-                
-                if (fdelta >= ((threshold / static_cast<data_t>(K)) * (0.5 + epsilon))) {
-                    f->update(solution, x, solution.size());
-                    solution.push_back(x);
-                    if (id.has_value()) ids.push_back(id.value());
-                    fval += fdelta;
-                }
-            }
-            is_fitted = true;
-        }
-    };
-
-    /**
-     * @brief  Dense thresholding strategy (Algorithm 1 in the ICML paper). This basically simulates the SimpleGreedy / PreemptionStreaming algalgorithm with a slightly different sampling strategy for the thresholds. In the original version OPT is known and different epsilon are used to "sample" different thresholds. As detailed in the longer version arxiv version of the paper, we can estimate OPT via \f$O = \{(1+\varepsilon)^i \mid i \in \mathbb{Z}, m \le (1+\varepsilon)^i \le K \cdot m\}\f$ where \f$ m = \max f({m}) \f$ is the maximum singleton function value. 
-     */
-    class Dense : public SubmodularOptimizer {
-    private:
-        // Sampled OPT threshold 
-        data_t threshold;
-
-        // Additional hyper parameters
-        data_t beta;
-        data_t C1;
-        data_t C2;
-
-        // Total number of items in the datastream
-        unsigned int N;
-
-        // Total number of observed items so far
-        unsigned int observed;
-
-    public:
-    
-        /**
-         * @brief Construct a new Dense object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
-         * @param  threshold: The (sampled) OPT threshold
-         * @param  beta: The \f$\beta\f$ parameter
-         * @param  C1: The \f$\C_1\f$ parameter
-         * @param  C2: The \f$C_2\f$ parameter
-         * @param  N: The number of items in the datastream
-         */
-        Dense(unsigned int K, SubmodularFunction & f, data_t threshold, data_t beta, data_t C1, data_t C2, unsigned int N) 
-            : SubmodularOptimizer(K,f), threshold(threshold), beta(beta), C1(C1), C2(C2), N(N), observed(0) {}
-
-        /**
-         * @brief Construct a new Dense object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state.
-         * @param  threshold: The (sampled) OPT threshold
-         * @param  beta: The \f$\beta\f$ parameter
-         * @param  C1: The \f$\C_1\f$ parameter
-         * @param  C2: The \f$C_2\f$ parameter
-         * @param  N: The number of items in the datastream
-         */
-        Dense(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t threshold, data_t beta, data_t C1, data_t C2, unsigned int N) 
-            : SubmodularOptimizer(K,f), threshold(threshold), beta(beta), C1(C1), C2(C2), N(N), observed(0) {}
-
-        /**
-         * @brief Throws an exception when called. FixedThreshold should not be used outside Salsa.
-         * 
-         * @param X A constant reference to the entire data set
-         * @param iterations: Number of iterations over the entire dataset
-         */
-        void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
-            throw std::runtime_error("FixedThresholds are only meant to be used through Salsa and therefore do not require the implementation of `fit'");
-        }
-
-        /**
-         * @brief  Consume the next object in the data stream. Add the current item to the summary if there are fewer than K element in it and if the items gain exceeds the current thresholding rule. Performs one function query.
-         * 
-         * @param  &x: A constant reference to the next object on the stream.
-         * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
-         */
-        void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-            unsigned int Kcur = solution.size();
-            if (Kcur < K) {
-                data_t fdelta = f->peek(solution, x, solution.size()) - fval;
-
-                if (static_cast<data_t>(observed) <= beta * static_cast<data_t>(N)) {
-                    // First threshold
-                    if (fdelta >= (C1 * threshold) / static_cast<data_t>(K)) {
-                        f->update(solution, x, solution.size());
-                        solution.push_back(x);
-                        if (id.has_value()) ids.push_back(id.value());
-                        fval += fdelta;
-                    }
-                } else {
-                    // Second threshold
-                    if (fdelta >= threshold / (C2 * static_cast<data_t>(K))) {
-                        f->update(solution, x, solution.size());
-                        solution.push_back(x);
-                        if (id.has_value()) ids.push_back(id.value());
-                        fval += fdelta;
-                    }
-                }
-            }
-            observed++;
-            is_fitted = true;
-        }
-    };
-
-    /**
-     * @brief  High-Low thresholding strategy (Algorithm 3 in in the ICML paper]). This basically combines Dense and FixedThresholding. In the original version OPT is known and different epsilon are used to "sample" different thresholds. As detailed in the longer arxiv version of the paper, we can estimate OPT via \f$O = \{(1+\varepsilon)^i \mid i \in \mathbb{Z}, m \le (1+\varepsilon)^i \le K \cdot m\}\f$ where \f$ m = \max f({m}) \f$ is the maximum singleton function value. 
-     */
-    class HighLowThreshold : public SubmodularOptimizer {
-    private:
-        // Sampled OPT threshold 
-        data_t threshold;
-
-        // Additional hyper parameters
-        data_t epsilon;
-        data_t beta;
-        data_t delta;
-
-        // Total number of items in the datastream
-        unsigned int N;
-
-        // Total number of observed items so far
-        unsigned int observed;
-
-    public:
-
-        /**
-         * @brief Construct a new HighLowThreshold object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
-         * @param  epsilon: The \f$\epsilon\f$ parameter
-         * @param  threshold: The (sampled) OPT threshold
-         * @param  beta: The \f$\beta\f$ parameter
-         * @param  delta: The \f$\delta\f$ parameter
-         * @param  N: The number of items in the datastream
-         */
-        HighLowThreshold(unsigned int K, SubmodularFunction & f, data_t epsilon, data_t threshold, data_t beta, data_t delta, unsigned int N) 
-            : SubmodularOptimizer(K,f), epsilon(epsilon), threshold(threshold), beta(beta), delta(delta), N(N), observed(0) {}
-
-        /**
-         * @brief Construct a new HighLowThreshold object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state.
-         * @param  epsilon: The \f$\epsilon\f$ parameter
-         * @param  threshold: The (sampled) OPT threshold
-         * @param  beta: The \f$\beta\f$ parameter
-         * @param  delta: The \f$\delta\f$ parameter
-         * @param  N: The number of items in the datastream
-         */
-        HighLowThreshold(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t epsilon, data_t threshold, data_t beta, data_t delta, unsigned int N) 
-            : SubmodularOptimizer(K,f),  epsilon(epsilon), threshold(threshold), beta(beta), delta(delta), N(N), observed(0) {}
-
-        /**
-         * @brief Throws an exception when called. FixedThreshold should not be used outside Salsa.
-         * 
-         * @param X A constant reference to the entire data set
-         * @param iterations: Number of iterations over the entire dataset
-         */
-        void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
-            throw std::runtime_error("HighLowThreshold are only meant to be used through Salsa and therefore do not require the implementation of `fit'");
-        }
-
-        /**
-         * @brief  Consume the next object in the data stream. Add the current item to the summary if there are fewer than K element in it and if the items gain exceeds the current thresholding rule. Performs one function query.
-         * 
-         * @param  &x: A constant reference to the next object on the stream.
-         * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
-         */
-        void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-            unsigned int Kcur = solution.size();
-            if (Kcur < K) {
-                data_t fdelta = f->peek(solution, x, solution.size()) - fval;
-
-                if (static_cast<data_t>(observed) <= beta * static_cast<data_t>(N)) {
-                    // High threshold
-                    if (fdelta >= ((threshold / static_cast<data_t>(K)) * (0.5 + epsilon))) {
-                        f->update(solution, x, solution.size());
-                        solution.push_back(x);
-                        if (id.has_value()) ids.push_back(id.value());
-                        fval += fdelta;
-                    }
-                } else {
-                    // Low threshold
-                    if (fdelta >= ((threshold / static_cast<data_t>(K)) * (0.5 - delta))) {
-                        f->update(solution, x, solution.size());
-                        solution.push_back(x);
-                        if (id.has_value()) ids.push_back(id.value());
-                        fval += fdelta;
-                    }
-                }
-            }
-            observed++;
-            is_fitted = true;
-        }
-    };
-    
+    enum class Strategy { Fixed, HighLow, Dense };
 
-protected:
-    // List of all algorithm which are run in parallel
-    std::vector<std::unique_ptr<SubmodularOptimizer>> algos;
+    // All strategies for all thresholds. The tag of each sieve is its strategy. Strategies which accepted the same items share their summary and their function state, and summaries with the same function value are ordered by their threshold and strategy.
+    SieveBank bank;
 
     // Maximum singleton item value
     data_t m;
@@ -333,6 +86,107 @@ protected:
 
     //FixedThreshold
     data_t fixed_epsilon;
+
+    // The threads which evaluate the groups of strategies in parallel
+    ThreadPool threads;
+
+    // The (estimated) number of items in the stream which is used by Dense and HighLow, whether the estimate is doubled once
+    // the stream gets longer and the number of items observed so far
+    unsigned long N;
+    bool doubling;
+    unsigned long observed;
+
+    /**
+     * @brief  Creates a single group with all strategies for all thresholds. This happens lazily on the first item.
+     */
+    void init() {
+        std::vector<data_t> ts;
+        std::vector<unsigned int> strategies;
+        for (auto t : thresholds(m, K*m, epsilon)) {
+            for (auto s : {Strategy::Fixed, Strategy::HighLow, Strategy::Dense}) {
+                ts.push_back(t);
+                strategies.push_back(static_cast<unsigned int>(s));
+            }
+        }
+        bank.add(ts, strategies);
+    }
+
+    /**
+     * @brief  Returns the acceptance rule of the given strategy: An item is accepted if its gain is at least the early threshold as long as at most \f$\beta \cdot N\f$ items have been observed and the late threshold afterwards.
+     * @param  threshold: The (sampled) OPT threshold.
+     * @param  strategy: The strategy.
+     */
+    SieveBank::Rule rule(data_t threshold, unsigned int strategy) const {
+        switch (static_cast<Strategy>(strategy)) {
+            case Strategy::HighLow:
+                // High and low threshold
+                return {
+                    (threshold / static_cast<data_t>(K)) * (0.5 + hilow_epsilon), 
+                    (threshold / static_cast<data_t>(K)) * (0.5 - hilow_delta), 
+                    hilow_beta * static_cast<data_t>(N)
+                };
+            case Strategy::Dense:
+                // First and second threshold
+                return {
+                    (dense_C1 * threshold) / static_cast<data_t>(K), 
+                    threshold / (dense_C2 * static_cast<data_t>(K)), 
+                    dense_beta * static_cast<data_t>(N)
+                };
+            default: {
+                data_t tau = (threshold / static_cast<data_t>(K)) * (0.5 + fixed_epsilon);
+                return {tau, tau, std::numeric_limits<data_t>::infinity()};
+            }
+        }
+    }
+
+    /**
+     * @brief  Lets all groups consume x and updates the best solution. This does not change the estimate of N.
+     * @param  &x: A constant reference to the next object on the stream.
+     * @param  id: The id of the given object.
+     */
+    void process(std::vector<data_t> const &x, std::optional<idx_t> const id) {
+        bank.next(x, id, static_cast<data_t>(observed++), threads);
+
+        int best = bank.best(fval);
+        if (best >= 0) {
+            fval = bank.get_fval(best);
+            solution = bank.get_summary(best).solution;
+            ids = bank.get_summary(best).ids;
+        }
+        is_fitted = true;
+    }
+
+    /**
+     * @brief  Processes the elements X[begin], ..., X[end - 1] group by group instead of element by element, so that the state of each group stays in the cache while it consumes the entire block (see SieveBank::run_block). The best function value of each group during the block, the position where it was reached and the size of the summary at that time are recorded to pick the same solution as `next` would have. If the block reaches the estimate of N, the estimate may change in the middle of the block and the block is processed element by element.
+     */
+    void next_block(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & X_ids, unsigned int begin, unsigned int end) {
+        if (bank.size() == 0) {
+            init();
+        }
+
+        // In the parallel mode the groups are evaluated element by element
+        if (threads.size() > 1 || end - begin < 2 || (doubling && observed + (end - begin) > N)) {
+            SubmodularOptimizer::next_block(X, X_ids, begin, end);
+            return;
+        }
+
+        bank.start_block(X, begin, end);
+        bank.run_block(X, X_ids, begin, observed, std::numeric_limits<data_t>::infinity());
+        bank.end_block();
+        observed += end - begin;
+
+        // Solutions only grow, hence the solution at that time is a prefix of the current one
+        int best = bank.best_in_block(fval);
+        if (best >= 0) {
+            SieveBank::Summary const & s = bank.get_summary(best);
+            SieveBank::Progress const & p = bank.get_progress(best);
+            fval = p.fval;
+            solution.assign(s.solution.begin(), s.solution.begin() + p.size);
+            ids.assign(s.ids.begin(), s.ids.begin() + p.num_ids);
+        }
+        is_fitted = true;
+    }
+
 public:
 
     /**
@@ -348,6 +202,8 @@ public:
      * @param  dense_C1: The \f$C_1\f$ parameter of the Dense thresholding algorithm
      * @param  dense_C2: The \f$C_2\f$ parameter of the Dense thresholding algorithm
      * @param  fixed_epsilon: The \f$\epsilon\f$ parameter of the Fixed thresholding algorithm
+     * @param  num_threads: The number of threads which evaluate the groups of strategies in parallel. If this is 0, then one thread per core is used. Note, that all groups share the same function if it is passed as std::function, which then must be thread-safe.
+     * @param  N: The (estimated) number of items in the stream, which is used by `next`. If this is 0, then N is unknown and a doubling schedule is used: The first estimate is K and it is doubled whenever the stream gets longer. `fit` always uses the size of the data set.
      */
     Salsa(unsigned int K, SubmodularFunction & f, data_t m, data_t epsilon,
         data_t hilow_epsilon = 0.05,
@@ -356,8 +212,11 @@ public:
         data_t dense_beta = 0.8,
         data_t dense_C1 = 10,
         data_t dense_C2 = 0.2,
-        data_t fixed_epsilon = 1.0 / 6.0
+        data_t fixed_epsilon = 1.0 / 6.0,
+        unsigned int num_threads = 1,
+        unsigned long N = 0
     ) : SubmodularOptimizer(K,f), 
+        bank(K, this->f, false, [this](data_t threshold, unsigned int strategy) { return rule(threshold, strategy); }),
         m(m),epsilon(epsilon), 
         hilow_epsilon(hilow_epsilon),
         hilow_beta(hilow_beta),
@@ -365,7 +224,11 @@ public:
         dense_beta(dense_beta),
         dense_C1(dense_C1),
         dense_C2(dense_C2),
-        fixed_epsilon(fixed_epsilon)
+        fixed_epsilon(fixed_epsilon),
+        threads(num_threads),
+        N(N > 0 ? N : K),
+        doubling(N == 0),
+        observed(0)
     {}
 
     /**
@@ -381,6 +244,8 @@ public:
      * @param  dense_C1: The \f$C_1\f$ parameter of the Dense thresholding algorithm
      * @param  dense_C2: The \f$C_2\f$ parameter of the Dense thresholding algorithm
      * @param  fixed_epsilon: The \f$\epsilon\f$ parameter of the Fixed thresholding algorithm
+     * @param  num_threads: The number of threads which evaluate the groups of strategies in parallel. If this is 0, then one thread per core is used. Note, that all groups share the same function if it is passed as std::function, which then must be thread-safe.
+     * @param  N: The (estimated) number of items in the stream, which is used by `next`. If this is 0, then N is unknown and a doubling schedule is used: The first estimate is K and it is doubled whenever the stream gets longer. `fit` always uses the size of the data set.
      */
     Salsa(unsigned int K, 
         std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t m, data_t epsilon,
@@ -390,8 +255,11 @@ public:
         data_t dense_beta = 0.8,
         data_t dense_C1 = 10,
         data_t dense_C2 = 0.2,
-        data_t fixed_epsilon = 1.0 / 6.0
+        data_t fixed_epsilon = 1.0 / 6.0,
+        unsigned int num_threads = 1,
+        unsigned long N = 0
     ) : SubmodularOptimizer(K,f), 
+        bank(K, this->f, false, [this](data_t threshold, unsigned int strategy) { return rule(threshold, strategy); }),
         m(m),epsilon(epsilon),
         hilow_epsilon(hilow_epsilon),
         hilow_beta(hilow_beta),
@@ -399,26 +267,25 @@ public:
         dense_beta(dense_beta),
         dense_C1(dense_C1),
         dense_C2(dense_C2),
-        fixed_epsilon(fixed_epsilon)
+        fixed_epsilon(fixed_epsilon),
+        threads(num_threads),
+        N(N > 0 ? N : K),
+        doubling(N == 0),
+        observed(0)
     {}
 
     /**
-     * @brief  Returns the number of thresholding algorithms used in parallel. Each algorithm stores at most one full summary.
+     * @brief  Returns the number of distinct candidate solutions. Strategies which accepted the same items share their solution and are counted once.
      */
     unsigned int get_num_candidate_solutions() const {
-        return algos.size();
+        return bank.size();
     }
 
     /**
-     * @brief  Returns the total number of items stored across all algorithms.
+     * @brief  Returns the total number of items stored across all (distinct) candidate solutions.
      */
     unsigned long get_num_elements_stored() const {
-        unsigned long num_elements = 0;
-        for (auto const & s : algos) {
-            num_elements += s->get_solution().size();
-        }
-
-        return num_elements;
+        return bank.get_num_elements_stored();
     }
 
     /**
@@ -426,36 +293,33 @@ public:
      * 
      * @param X A constant reference to the entire data set
      * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks. 
-     * @param iterations: Has no effect. Greedy iterates K times over the entire dataset in any case.
+     * @param iterations: Maximum number of iterations over the entire data-set (default = 1). Early exits once K elements are found and at-least one iteration is completed.
      */
     void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
-        unsigned int N = X.size();
-        std::vector<data_t> ts = thresholds(m, K*m, epsilon);
-        for (auto t : ts) {
-            algos.push_back(std::make_unique<FixedThreshold>(K, *f, fixed_epsilon, t));
-            algos.push_back(std::make_unique<HighLowThreshold>(K, *f, hilow_epsilon, t, hilow_beta, hilow_delta, N));
-            algos.push_back(std::make_unique<Dense>(K, *f, t, dense_beta, dense_C1, dense_C2, N));
+        N = X.size();
+        if (bank.size() == 0) {
+            init();
         }
+        bank.refresh();
 
         for (unsigned int i = 0; i < iterations; ++i) {
+            if (i == 0) {
+                // There is no early exit in the first iteration, hence we can process the data in blocks
+                for (unsigned int j = 0; j < X.size(); j += block_size) {
+                    next_block(X, ids, j, std::min(static_cast<unsigned int>(X.size()), j + block_size));
+                }
+                continue;
+            }
+
             for (unsigned int j = 0; j < X.size(); ++j) {
-            //for (auto &x : X) {
-                for (auto &s : algos) {
-                    if (ids.size() == X.size()) {
-                        s->next(X[j], ids[j]);
-                    } else {
-                        s->next(X[j]);
-                    }
-                    if (s->get_fval() > fval) {
-                        fval = s->get_fval();
-                        // TODO THIS IS A COPY AT THE MOMENT
-                        solution = s->solution;
-                        is_fitted = true;
-                    }
-                    
-                    if (solution.size() == K && i > 0) {
-                        return;
-                    }
+                if (j < ids.size()) {
+                    process(X[j], ids[j]);
+                } else {
+                    process(X[j], std::nullopt);
+                }
+
+                if (solution.size() == K) {
+                    return;
                 }
             }
         }
@@ -465,7 +329,7 @@ public:
      * @brief Executes all different thresholding algorithm in parallel and picks that one with the best summary. 
      * @note This internally calls fit with an empty id set.
      * @param X A constant reference to the entire data set
-     * @param iterations: Has no effect. Greedy iterates K times over the entire dataset in any case.
+     * @param iterations: Maximum number of iterations over the entire data-set (default = 1). Early exits once K elements are found and at-least one iteration is completed.
      */
     void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
         std::vector<idx_t> ids;
@@ -473,13 +337,22 @@ public:
     }
 
     /**
-     * @brief Throws an exception when called. Salsa does not support streaming!
+     * @brief  Consume the next object in the data stream. The strategies are created on the first call. Dense and HighLow switch their thresholds after a fraction of the stream has been observed, which is based on the (estimated) N given in the constructor. If N is unknown, then the estimate is doubled whenever the stream gets longer than the current estimate.
      * 
-     * @param x A constant reference to the next object on the stream.
+     * @param  &x: A constant reference to the next object on the stream.
+     * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
      */
     void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-        throw std::runtime_error("Salsa does not support streaming data, please use fit().");
+        if (bank.size() == 0) {
+            init();
+        }
+
+        if (doubling && observed >= N) {
+            N *= 2;
+            bank.refresh();
+        }
+        process(x, id);
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,567 @@
+#ifndef SIEVEBANK_H
+#define SIEVEBANK_H
+
+#include <vector>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <limits>
+#include <algorithm>
+
+#include "DataTypeHandling.h"
+#include "SubmodularFunction.h"
+#include "ElementPool.h"
+#include "ThreadPool.h"
+
+/**
+ * @brief  The sieves of a threshold-based streaming optimizer (SieveStreaming, SieveStreamingPP and Salsa). Each sieve has a threshold, a tag (e.g. the strategy in Salsa) and an acceptance rule: An element is accepted if its gain is at least tau. Tau is the early level of the sieve as long as at most `until` elements have been observed and its late level afterwards. For budget rules the level is spread across the remaining slots of the summary, i.e. tau = (level - fval) / (K - Kcur) as in SieveStreaming.
+ * Sieves which accepted exactly the same elements form a group and share a single summary and a single SubmodularFunction state. If only some sieves of a group accept an element, the group is split (copy-on-write): The accepting sieves receive a copy of the state (see SubmodularFunction::copy) whereas the rejecting sieves keep the original one.
+ * All data is stored in contiguous arrays: The thresholds, tags and rules of all sieves are stored per sieve and the sieves of a group form a contiguous range of these arrays, which is sorted by (threshold, tag). The function values and summary sizes are stored per group, whereas the remaining state of each group lives in a parallel array of summaries, which is only touched if an element may be accepted. Thus, the smallest tau of a group is found with a single (vectorizable) pass over its rules, which is cached until the level of a sieve changes. Each element is then checked against the smallest tau of every group and the upper bound of its gain w.r.t. the empty summary (see SubmodularFunction::gain_upper_bound), so that only the groups which could accept it touch their summary and only these are distributed across threads.
+ */
+class SieveBank {
+public:
+    /**
+     * @brief  The acceptance rule of a sieve: Its level is early as long as at most until elements have been observed and late afterwards.
+     */
+    struct Rule {
+        data_t early;
+        data_t late;
+        data_t until;
+    };
+
+    /**
+     * @brief  The state which is shared by all sieves of a group.
+     */
+    struct Summary {
+        // The shared function state
+        std::shared_ptr<SubmodularFunction> f;
+
+        // The shared summary and its ids
+        std::vector<std::vector<data_t>> solution;
+        std::vector<idx_t> ids;
+
+        // The slot of each element of the summary in the pool. This is cleared once the summary is full.
+        std::vector<unsigned int> pool_ids;
+    };
+
+    /**
+     * @brief  The progress of a group in the current block (see run_block): The next position in the block, the best function value of the group in the block and the position and size of its solution / ids when this value was reached.
+     */
+    struct Progress {
+        unsigned int cursor;
+        data_t fval;
+        unsigned int pos;
+        size_t size;
+        size_t num_ids;
+    };
+
+private:
+    unsigned int K;
+
+    // The function of the optimizer, which is cloned for new groups
+    std::shared_ptr<SubmodularFunction> f;
+
+    // True if the levels are spread across the remaining slots of the summary
+    bool budget;
+
+    // Computes the rule of a sieve from its threshold and tag
+    std::function<Rule (data_t, unsigned int)> rule;
+
+    // The sieves. The sieves of the g-th group are begins[g], ..., begins[g + 1] - 1.
+    std::vector<data_t> thresholds;
+    std::vector<unsigned int> tags;
+    std::vector<data_t> earlies;
+    std::vector<data_t> lates;
+    std::vector<data_t> untils;
+
+    // The groups. levels caches the smallest level of each group which is valid as long as at most valid[g] elements have been observed.
+    std::vector<unsigned int> begins;
+    std::vector<data_t> fvals;
+    std::vector<unsigned int> sizes;
+    std::vector<data_t> levels;
+    std::vector<data_t> valid;
+    std::vector<Summary> summaries;
+    std::vector<Progress> progress;
+
+    // The distinct elements of all summaries which are not full yet
+    ElementPool pool;
+
+    // The groups which may accept the current element, their smallest tau and their gain in the parallel mode
+    std::vector<unsigned int> active;
+    std::vector<data_t> taus;
+    std::vector<std::optional<data_t>> gains;
+
+    // The sieves accepting the current element and the upper bounds on the gain of each element of the current block
+
+    std::vector<char> accepting;
+    std::vector<data_t> bounds;
+
+    unsigned int end(unsigned int g) const {
+        return g + 1 < begins.size() ? begins[g + 1] : thresholds.size();
+    }
+
+    /**
+     * @brief  Returns the upper bound on the gain of x w.r.t. the empty summary. Since the gain of x can only decrease as a summary grows, this bounds the gain of x for any group.
+     */
+    data_t bound(std::vector<data_t> const &x) {
+        static const std::vector<std::vector<data_t>> empty;
+        return f->gain_upper_bound(empty, x);
+    }
+
+    /**
+     * @brief  Returns the smallest tau of the g-th group after t elements have been observed. If the element does not pass this one, it passes none of the group.
+     */
+    data_t tau(unsigned int g, data_t t) {
+        if (!(t <= valid[g])) {
+            // The early levels remain valid until the first early sieve switches to its late level
+            data_t level = std::numeric_limits<data_t>::infinity();
+            data_t until = std::numeric_limits<data_t>::infinity();
+            for (unsigned int i = begins[g], e = end(g); i < e; ++i) {
+                bool early = t <= untils[i];
+                level = std::min(level, early ? earlies[i] : lates[i]);
+                until = std::min(until, early ? untils[i] : std::numeric_limits<data_t>::infinity());
+            }
+            levels[g] = level;
+            valid[g] = until;
+        }
+        return budget ? (levels[g] - fvals[g]) / static_cast<data_t>(K - sizes[g]) : levels[g];
+    }
+
+    void invalidate(unsigned int g) {
+        valid[g] = std::numeric_limits<data_t>::lowest();
+    }
+
+    /**
+     * @brief  Stable partitions the range [b, e) of v, so that all positions i with accepting[i - b] come first.
+     */
+    template <typename T>
+    void partition(std::vector<T> &v, unsigned int b, unsigned int e) {
+        std::vector<T> rejecting;
+        unsigned int k = b;
+        for (unsigned int i = b; i < e; ++i) {
+            if (accepting[i - b]) {
+                v[k++] = v[i];
+            } else {
+                rejecting.push_back(v[i]);
+            }
+        }
+        std::copy(rejecting.begin(), rejecting.end(), v.begin() + k);
+    }
+
+    /**
+     * @brief  Keeps all sieves for which keep(g, i) is true, where g is the group of the i-th sieve. Groups without any sieve are removed and release their elements.
+     * @retval The number of removed sieves.
+     */
+    template <typename Keep>
+    unsigned int compact(Keep keep) {
+        unsigned int si = 0, gj = 0, removed = 0;
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            unsigned int start = si, e = end(g);
+            for (unsigned int i = begins[g]; i < e; ++i) {
+                if (keep(g, i)) {
+                    thresholds[si] = thresholds[i];
+                    tags[si] = tags[i];
+                    earlies[si] = earlies[i];
+                    lates[si] = lates[i];
+                    untils[si] = untils[i];
+                    ++si;
+                }
+            }
+            removed += (e - begins[g]) - (si - start);
+
+            if (si == start) {
+                for (auto p : summaries[g].pool_ids) {
+                    pool.release(p);
+                }
+                continue;
+            }
+
+            if (si - start != e - begins[g]) {
+                invalidate(g);
+            }
+            begins[gj] = start;
+            fvals[gj] = fvals[g];
+            sizes[gj] = sizes[g];
+            levels[gj] = levels[g];
+            valid[gj] = valid[g];
+            progress[gj] = progress[g];
+            if (gj != g) {
+                summaries[gj] = std::move(summaries[g]);
+            }
+            ++gj;
+        }
+
+        for (auto v : {&thresholds, &earlies, &lates, &untils}) {
+            v->resize(si);
+        }
+        tags.resize(si);
+        for (auto v : {&fvals, &levels, &valid}) {
+            v->resize(gj);
+        }
+        begins.resize(gj);
+        sizes.resize(gj);
+        summaries.resize(gj);
+        progress.resize(gj);
+        return removed;
+    }
+
+public:
+    /**
+     * @brief  Creates a new, empty bank.
+     * @param  K: The cardinality constraint.
+     * @param  f: The function of the optimizer. Each new group receives a clone of it.
+     * @param  budget: True if the levels are spread across the remaining slots of the summary (see SieveBank).
+     * @param  rule: Computes the rule of a sieve from its threshold and tag.
+     */
+    SieveBank(unsigned int K, std::shared_ptr<SubmodularFunction> f, bool budget, std::function<Rule (data_t, unsigned int)> rule)
+        : K(K), f(f), budget(budget), rule(rule), pool(f) {}
+
+    /**
+     * @brief  Adds a new group of sieves with an empty summary.
+     * @param  &ts: The thresholds of the new sieves.
+     * @param  &ts_tags: The tags of the new sieves. Together with the thresholds they must be sorted in ascending order.
+     * @param  cursor: The position in the current block at which the group starts (see run_block).
+     */
+    void add(std::vector<data_t> const &ts, std::vector<unsigned int> const &ts_tags, unsigned int cursor = 0) {
+        if (ts.empty()) {
+            return;
+        }
+
+        begins.push_back(thresholds.size());
+        for (unsigned int i = 0; i < ts.size(); ++i) {
+            Rule r = rule(ts[i], ts_tags[i]);
+            thresholds.push_back(ts[i]);
+            tags.push_back(ts_tags[i]);
+            earlies.push_back(r.early);
+            lates.push_back(r.late);
+            untils.push_back(r.until);
+        }
+        fvals.push_back(0);
+        sizes.push_back(0);
+        levels.push_back(0);
+        valid.push_back(std::numeric_limits<data_t>::lowest());
+        summaries.push_back({f->clone(), {}, {}, {}});
+        progress.push_back({cursor, std::numeric_limits<data_t>::lowest(), 0, 0, 0});
+    }
+
+    /**
+     * @brief  Re-computes the rules of all sieves, e.g. if the rules depend on the (estimated) length of the stream which changed.
+     */
+    void refresh() {
+        for (unsigned int i = 0; i < thresholds.size(); ++i) {
+            Rule r = rule(thresholds[i], tags[i]);
+            earlies[i] = r.early;
+            lates[i] = r.late;
+            untils[i] = r.until;
+        }
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            invalidate(g);
+        }
+    }
+
+    /**
+     * @brief  Removes all sieves whose threshold is below the given threshold.
+     * @retval The number of removed sieves.
+     */
+    unsigned int erase_below(data_t threshold) {
+        if (std::none_of(thresholds.begin(), thresholds.end(), [&](data_t th) { return th < threshold; })) {
+            return 0;
+        }
+        return compact([&](unsigned int, unsigned int i) { return thresholds[i] >= threshold; });
+    }
+
+    /**
+     * @brief  Removes all groups for which retired(fval, size) is true.
+     * @retval The number of removed sieves.
+     */
+    template <typename Retired>
+    unsigned int retire(Retired retired) {
+        unsigned int first = 0;
+        while (first < begins.size() && !retired(fvals[first], sizes[first])) {
+            ++first;
+        }
+        if (first == begins.size()) {
+            return 0;
+        }
+        return compact([&](unsigned int g, unsigned int) { return !retired(fvals[g], sizes[g]); });
+    }
+
+private:
+    /**
+     * @brief  Computes the gain of x for the g-th group. This only reads the group and the pool, so that it can be called for different groups in parallel. The caller has to set x as the current element of the pool beforehand and make sure that the summary of the group is not full.
+     * @param  g: The group.
+     * @param  &x: The current element of the pool.
+     * @param  tau_min: The smallest tau of the group (see tau).
+     * @retval The gain or std::nullopt if no sieve of the group can accept x.
+     */
+    std::optional<data_t> gain(unsigned int g, std::vector<data_t> const &x, data_t tau_min) {
+        Summary & s = summaries[g];
+        if (s.f->gain_upper_bound(s.solution, x) >= tau_min) {
+            return s.f->peek_pooled(s.solution, x, sizes[g], pool.get_row(), s.pool_ids) - fvals[g];
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief  Adds x to all sieves of the g-th group which accept it. If only some sieves accept x, then the group is split: The accepting sieves receive a copy of the state and are inserted as a new group at position g, whereas the rejecting sieves keep the original state at position g + 1. The caller has to set x as the current element of the pool beforehand.
+     * @param  g: The group.
+     * @param  &x: The current element of the pool.
+     * @param  id: The id of x.
+     * @param  fdelta: The gain of x for the group as computed by `gain`.
+     * @param  t: The number of elements observed before x.
+     * @retval True if the group has been split.
+     */
+    bool accept(unsigned int g, std::vector<data_t> const &x, std::optional<idx_t> const id, data_t fdelta, data_t t) {
+        unsigned int b = begins[g], e = end(g);
+        unsigned int Kcur = sizes[g];
+        data_t fval = fvals[g];
+
+        accepting.resize(e - b);
+        unsigned int accepted = 0;
+        for (unsigned int i = b; i < e; ++i) {
+            data_t level = t <= untils[i] ? earlies[i] : lates[i];
+            data_t tau = budget ? (level - fval) / static_cast<data_t>(K - Kcur) : level;
+            accepting[i - b] = fdelta >= tau;
+            accepted += accepting[i - b];
+        }
+        if (accepted == 0) {
+            return false;
+        }
+
+        bool split = accepted < e - b;
+        if (split) {
+            // The acceptance decisions diverge. The accepting sieves are moved to the front of the range, so that they form the fork in front of the rejecting ones.
+            if (!std::is_sorted(accepting.begin(), accepting.end(), std::greater<char>())) {
+                partition(thresholds, b, e);
+                partition(tags, b, e);
+                partition(earlies, b, e);
+                partition(lates, b, e);
+                partition(untils, b, e);
+            }
+
+            Summary & s = summaries[g];
+            Summary fork {s.f->copy(s.solution), s.solution, s.ids, s.pool_ids};
+            Progress p = progress[g];
+            for (auto p : fork.pool_ids) {
+                pool.retain(p);
+            }
+
+            begins.insert(begins.begin() + g + 1, b + accepted);
+            fvals.insert(fvals.begin() + g, fval);
+            sizes.insert(sizes.begin() + g, Kcur);
+            levels.insert(levels.begin() + g, 0);
+            valid.insert(valid.begin() + g, 0);
+            progress.insert(progress.begin() + g, p);
+            summaries.insert(summaries.begin() + g, std::move(fork));
+            invalidate(g);
+            invalidate(g + 1);
+        }
+
+        Summary & s = summaries[g];
+        s.f->update(s.solution, x, Kcur);
+        s.solution.push_back(x);
+        if (id.has_value()) s.ids.push_back(id.value());
+        fvals[g] += fdelta;
+        ++sizes[g];
+
+        if (sizes[g] < K) {
+            unsigned int slot = pool.insert_current();
+            pool.retain(slot);
+            s.pool_ids.push_back(slot);
+        } else {
+            // Full summaries are never peeked again, hence they do not need the pool anymore
+            for (auto p : s.pool_ids) {
+                pool.release(p);
+            }
+            s.pool_ids.clear();
+        }
+
+        return split;
+    }
+
+public:
+    /**
+     * @brief  Lets all groups consume x.
+     * @param  &x: A constant reference to the next object on the stream.
+     * @param  id: The id of x.
+     * @param  t: The number of elements observed before x.
+     * @param  &threads: The threads which evaluate the groups in parallel.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> const id, data_t t, ThreadPool & threads) {
+        // The pool_row of x is computed lazily by the first group which peeks and x is inserted into the pool by the first group which accepts it
+        pool.set_current(x);
+
+        // Only groups which are not full and whose smallest tau does not exceed the upper bound on the gain of x can accept x
+        active.clear();
+        taus.clear();
+        std::optional<data_t> ub;
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            if (sizes[g] < K) {
+                data_t tau_min = tau(g, t);
+                if (!ub.has_value()) ub = bound(x);
+                if (tau_min <= ub.value()) {
+                    active.push_back(g);
+                    taus.push_back(tau_min);
+                }
+            }
+        }
+
+        // Peeking is independent for each group, hence all gains can be computed in parallel. The groups are then
+        // updated in order, so that the result is the same as with a single thread.
+        bool parallel = threads.size() > 1 && active.size() > 1;
+        if (parallel) {
+            // The pool_row is computed once beforehand, so that the threads only read it
+            pool.get_row();
+            gains.resize(active.size());
+            threads.parallel_for(active.size(), [&](unsigned int a) {
+                gains[a] = gain(active[a], x, taus[a]);
+            });
+        }
+
+        // Each split inserts a group in front of the remaining active groups
+        for (unsigned int a = 0, splits = 0; a < active.size(); ++a) {
+            unsigned int g = active[a] + splits;
+            std::optional<data_t> fgain = parallel ? gains[a] : gain(g, x, taus[a]);
+            if (fgain.has_value() && accept(g, x, id, fgain.value(), t)) {
+                ++splits;
+            }
+        }
+    }
+
+    /**
+     * @brief  Starts processing the block X[begin], ..., X[end - 1] group by group (see run_block). All pool_rows of the block and the upper bounds of all elements are computed upfront.
+     */
+    void start_block(std::vector<std::vector<data_t>> const &X, unsigned int begin, unsigned int end) {
+        pool.insert_block(X, begin, end);
+        bounds.resize(end - begin);
+        for (unsigned int j = begin; j < end; ++j) {
+            bounds[j - begin] = bound(X[j]);
+        }
+        for (auto & p : progress) {
+            p = {0, std::numeric_limits<data_t>::lowest(), 0, 0, 0};
+        }
+    }
+
+    /**
+     * @brief  Lets each group consume the current block from its cursor onwards while its state is hot in the cache, until its function value exceeds the given limit. Groups are independent of each other, hence the state of each group is the same as if the block was processed element by element. If a group is split, the fork continues with the next element and the rejecting sieves are processed afterwards. Groups which stopped early can continue with another call.
+     * @param  &X: The data set. start_block must have been called beforehand.
+     * @param  &X_ids: The ids of the elements in X.
+     * @param  begin: The start of the block in X.
+     * @param  t: The number of elements observed before X[begin].
+     * @param  limit: The function value at which groups stop.
+     */
+    void run_block(std::vector<std::vector<data_t>> const &X, std::vector<idx_t> const & X_ids, unsigned int begin, unsigned long t, data_t limit) {
+        unsigned int B = bounds.size();
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            for (unsigned int j = progress[g].cursor; j < B && sizes[g] < K && fvals[g] <= limit; ++j) {
+                progress[g].cursor = j + 1;
+                data_t tj = static_cast<data_t>(t + j);
+                data_t tau_min = tau(g, tj);
+                if (tau_min > bounds[j]) {
+                    continue;
+                }
+
+                std::vector<data_t> const & x = X[begin + j];
+                pool.set_current_block(j);
+                std::optional<data_t> fgain = gain(g, x, tau_min);
+                if (!fgain.has_value()) {
+                    continue;
+                }
+
+                std::optional<idx_t> id = begin + j < X_ids.size() ? std::optional<idx_t>(X_ids[begin + j]) : std::nullopt;
+                accept(g, x, id, fgain.value(), tj);
+                if (fvals[g] > progress[g].fval) {
+                    progress[g] = {j + 1, fvals[g], j, sizes[g], summaries[g].ids.size()};
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief  Finishes the current block.
+     */
+    void end_block() {
+        pool.release_block();
+    }
+
+    /**
+     * @brief  Returns true if the sieves of the g1-th group come before the sieves of the g2-th group. This breaks ties between groups with the same function value, so that the result matches running each sieve on its own.
+     */
+    bool before(unsigned int g1, unsigned int g2) const {
+        unsigned int i1 = begins[g1], i2 = begins[g2];
+        return thresholds[i1] < thresholds[i2] || (thresholds[i1] == thresholds[i2] && tags[i1] < tags[i2]);
+    }
+
+    /**
+     * @brief  Returns the group with the largest function value above the given one or -1 if there is none.
+     */
+    int best(data_t above) const {
+        int b = -1;
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            if (fvals[g] > above && (b < 0 || fvals[g] > fvals[b] || (fvals[g] == fvals[b] && before(g, b)))) {
+                b = g;
+            }
+        }
+        return b;
+    }
+
+    /**
+     * @brief  Returns the group with the largest function value above the given one in the current block or -1 if there is none. Element by element, the largest function value which is reached first wins, so that the result matches processing the block element by element. The solution at that time is a prefix of the current one, whose size is given by get_progress.
+     */
+    int best_in_block(data_t above) const {
+        int b = -1;
+        for (unsigned int g = 0; g < begins.size(); ++g) {
+            Progress const & p = progress[g];
+            if (p.fval > above && (b < 0 || p.fval > progress[b].fval || (p.fval == progress[b].fval && (p.pos < progress[b].pos || (p.pos == progress[b].pos && before(g, b)))))) {
+                b = g;
+            }
+        }
+        return b;
+    }
+
+    /**
+     * @brief  Returns the number of groups.
+     */
+    unsigned int size() const {
+        return begins.size();
+    }
+
+    /**
+     * @brief  Returns the number of sieves.
+     */
+    unsigned int num_sieves() const {
+        return thresholds.size();
+    }
+
+    /**
+     * @brief  Returns the thresholds of all sieves. The thresholds are sorted within each group only.
+     */
+    std::vector<data_t> const & get_thresholds() const {
+        return thresholds;
+    }
+
+    data_t get_fval(unsigned int g) const {
+        return fvals[g];
+    }
+
+    Summary const & get_summary(unsigned int g) const {
+        return summaries[g];
+    }
+
+    Progress const & get_progress(unsigned int g) const {
+        return progress[g];
+    }
+
+    /**
+     * @brief  Returns the total number of elements stored across all groups.
+     */
+    unsigned long get_num_elements_stored() const {
+        unsigned long num_elements = 0;
+        for (auto s : sizes) {
+            num_elements += s;
+        }
+        return num_elements;
+    }
+};
+
+#endif // SIEVEBANK_H
@@ -3,7 +3,10 @@
 
 #include "DataTypeHandling.h"
 #include "SubmodularOptimizer.h"
+#include "SieveBank.h"
+#include "ThreadPool.h"
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <unordered_set>
@@ -59,7 +62,7 @@ inline std::vector<data_t> thresholds(data_t lower, data_t upper, data_t epsilon
  *  - lower = \f$ max_e f({e}) \f$  which is the largest function value of a singleton-set
  *  - upper = \f$ K \cdot max_e f({e}) \f$  which is \f$ K \f$ times the function value of a singleton-set
  *
- * Note that this implementation requires that \f$ m = max_e f({e}) \f$ is known beforehand
+ * Note that this implementation requires that \f$ m = max_e f({e}) \f$ is known beforehand. Since the gain of any element is at most \f$ m \f$, sieves which are full or which cannot improve the best solution anymore are retired while streaming, so that the work per element and the memory shrink over time (see `get_num_retired_sieves`).
  * 
  *  - Stream:  Yes
  *  - Solution: \f$ 1/2 - \varepsilon \f$
@@ -101,71 +104,35 @@ inline std::vector<data_t> thresholds(data_t lower, data_t upper, data_t epsilon
  * - Badanidiyuru, A., Mirzasoleiman, B., Karbasi, A., & Krause, A. (2014). Streaming submodular maximization: Massive data summarization on the fly. In Proceedings of the ACM SIGKDD International Conference on Knowledge Discovery and Data Mining. https://doi.org/10.1145/2623330.2623637
  */
 class SieveStreaming : public SubmodularOptimizer {
-private:
+protected:
 
-    /**
-     * @brief  A single sieve with its own threshold and accompanying summary.  
-     * @note   This class is basically also implemented in SieveStreamingPP and - to some extend - in Salsa. I decided against a unified class for these Sieves, since the thresholding rules are often slightly different from paper to paper. I tried to stick as close as possible to the pseudocode in the papers.
-     */
-    class Sieve : public SubmodularOptimizer {
-    public:
-        // The threshold
-        data_t threshold;
+    // All sieves. Sieves which accepted the same elements share their summary and their function state. Since the acceptance rule of every sieve is monotone in its threshold, the sieves of a group which accept an element always form a prefix of its (sorted) thresholds.
+    SieveBank bank;
 
-        /**
-         * @brief Construct a new Sieve object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that the ``clone` function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.  
-         * @param threshold The threshold.
-         */
-        Sieve(unsigned int K, SubmodularFunction & f, data_t threshold) : SubmodularOptimizer(K,f), threshold(threshold) {}
+    // Maximum singleton item value, which also bounds the gain of any element
+    data_t m;
 
-        /**
-         * @brief Construct a new Sieve object
-         * 
-         * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-         * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the **same** function they all reference the **same** function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state.
-         * @param threshold The threshold.
-         */
-        Sieve(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t threshold) : SubmodularOptimizer(K,f), threshold(threshold) {
-        }
+    // The number of sieves which have been retired since they cannot improve the best solution anymore (see retire)
+    unsigned int num_retired;
 
-        /**
-         * @brief Throws an exception since fit() should not be used directly here. Sieves are not meant to be used on their own, but only through SieveStreaming.
-         * 
-         * @param X A constant reference to the entire data set
-         */
-        void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
-            throw std::runtime_error("Sieves are only meant to be used through SieveStreaming and therefore do not require the implementation of `fit'");
-        }
+    // The threads which evaluate the groups in parallel
+    ThreadPool threads;
 
-        /**
-         * @brief Consume the next object in the data stream. This call compares the marginal gain against the given threshold and add the current item to the current solution if it exceeds the given threshold. 
-         * 
-         * @param  &x: A constant reference to the next object on the stream.
-         * @param  id: The id of the given object. If this is a ``std::nullopt`` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either **all** or **no** object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
-         */
-        void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-            unsigned int Kcur = solution.size();
-            if (Kcur < K) {
-                data_t fdelta = f->peek(solution, x, solution.size()) - fval;
-                data_t tau = (threshold / 2.0 - fval) / static_cast<data_t>(K - Kcur);
-
-                if (fdelta >= tau) {
-                    f->update(solution, x, solution.size());
-                    solution.push_back(x);
-                    if (id.has_value()) ids.push_back(id.value());
-                    fval += fdelta;
-                }
-            }
-            is_fitted = true;
-        }
-    };
+    /**
+     * @brief  Returns the acceptance rule of a sieve: An element is accepted if its gain is at least \f$ (v/2 - f(S)) / (K - |S|) \f$ where v is the threshold of the sieve and S its summary.
+     */
+    static SieveBank::Rule rule(data_t threshold, unsigned int) {
+        return {threshold / 2.0, threshold / 2.0, std::numeric_limits<data_t>::infinity()};
+    }
 
-protected:
-    // A list of all sieves
-    std::vector<std::unique_ptr<Sieve>> sieves;
+    /**
+     * @brief  Retires all groups which cannot improve the best solution anymore and releases their function state and their elements. Full groups never change again and have already been compared against the best solution. Since the gain of any element is at most m, a group with Kcur elements can reach at most fval + (K - Kcur) * m, so that it is dominated once this does not exceed the best fval. Retiring these groups does not change the result.
+     */
+    void retire() {
+        num_retired += bank.retire([&](data_t gval, unsigned int Kcur) {
+            return Kcur >= K || gval + static_cast<data_t>(K - Kcur) * m <= fval;
+        });
+    }
 
 public:
 
@@ -176,13 +143,11 @@ public:
      * @param f The function which should be maximized. Note, that the ``clone`` function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.  
      * @param m The maximum value of the singleton set, \f$ m = max_e f({e}) \f$
      * @param epsilon The sampling accuracy for threshold generation
+     * @param num_threads The number of threads which evaluate the sieves in parallel. If this is 0, then one thread per core is used. Note, that all sieves share the same function if it is passed as std::function, which then must be thread-safe.
      */
-    SieveStreaming(unsigned int K, SubmodularFunction & f, data_t m, data_t epsilon) : SubmodularOptimizer(K,f) {
+    SieveStreaming(unsigned int K, SubmodularFunction & f, data_t m, data_t epsilon, unsigned int num_threads = 1) : SubmodularOptimizer(K,f), bank(K, this->f, true, rule), m(m), num_retired(0), threads(num_threads) {
         std::vector<data_t> ts = thresholds(m, K*m, epsilon);
-
-        for (auto t : ts) {
-            sieves.push_back(std::make_unique<Sieve>(K, f, t));
-        }
+        bank.add(ts, std::vector<unsigned int>(ts.size(), 0));
     }
 
     /**
@@ -192,72 +157,80 @@ public:
      * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the **same** function they all reference the **same** function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state. 
      * @param m The maximum value of the singleton set, \f$ m = max_e f({e}) \f$
      * @param epsilon The sampling accuracy for threshold generation
+     * @param num_threads The number of threads which evaluate the sieves in parallel. If this is 0, then one thread per core is used. Note, that all sieves share the same function if it is passed as std::function, which then must be thread-safe.
      */
-    SieveStreaming(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t m, data_t epsilon) : SubmodularOptimizer(K,f) {
+    SieveStreaming(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t m, data_t epsilon, unsigned int num_threads = 1) : SubmodularOptimizer(K,f), bank(K, this->f, true, rule), m(m), num_retired(0), threads(num_threads) {
         std::vector<data_t> ts = thresholds(m, K*m, epsilon);
-        for (auto t : ts) {
-            sieves.push_back(std::make_unique<Sieve>(K, f, t));
-        }
+        bank.add(ts, std::vector<unsigned int>(ts.size(), 0));
     }
 
     /**
-     * @brief  Returns the number of sieves.
+     * @brief  Returns the number of distinct candidate solutions which are still active. Sieves which accepted the same elements share their solution and are counted once.
      */
     unsigned int get_num_candidate_solutions() const {
-        return sieves.size();
+        return bank.size();
     }
 
     /**
-     * @brief  Returns the total number of items stored across all sieves.
+     * @brief  Returns the number of sieves which have been retired, because they were full or could not improve the best solution anymore.
      */
-    unsigned long get_num_elements_stored() const {
-        unsigned long num_elements = 0;
-        for (auto const & s : sieves) {
-            num_elements += s->get_solution().size();
-        }
-
-        return num_elements;
+    unsigned int get_num_retired_sieves() const {
+        return num_retired;
     }
 
     /**
-     * @brief Destroy the Sieve Streaming object
-     * 
+     * @brief  Returns the total number of items stored across all (distinct) active sieves.
      */
-    ~SieveStreaming() {
-        // for (auto s : sieves) {
-        //     delete s;
-        // }
+    unsigned long get_num_elements_stored() const {
+        return bank.get_num_elements_stored();
     }
 
     /**
-     * @brief  Consume the next object in the data stream. This checks for each sieve if the given object exceeds the marginal gain thresholdhold and adds it to the corresponding solution.
+     * @brief  Consume the next object in the data stream. This checks for each sieve if the given object exceeds the marginal gain thresholdhold and adds it to the corresponding solution. Sieves with the same summary share a single peek and a single update. 
      * 
      * @param  &x: A constant reference to the next object on the stream.
      * @param  id: The id of the given object. If this is a ``std::nullopt`` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either **all** or **no** object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
      */
     void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-        // // MAX_GUESSED SHOULD BE bool TEMPLATE PARAM
-        // if constexpr (MAX_GUESSED) {
-        //     std::vector<std::vector<data_t>> singleton(1);
-        //     singleton[0] = x;
-        //     data_t mnew = f(singleton);
-        //     // m must be a member
-        //     if (mnew > m) {
-        //         m = mnew;
-        //         std::vector<data_t> ts = thresholds(m, 2*K*m, epsilon);
-        //         // delete all sieves with wrong thresholds
-        //     }
-        // }
-        for (auto &s : sieves) {
-            s->next(x, id);
-            if (s->get_fval() > fval) {
-                fval = s->get_fval();
-                // TODO THIS IS A COPY AT THE MOMENT
-                solution = s->solution;
-            }
+        bank.next(x, id, 0, threads);
+
+        int best = bank.best(fval);
+        if (best >= 0) {
+            fval = bank.get_fval(best);
+            solution = bank.get_summary(best).solution;
+            ids = bank.get_summary(best).ids;
+        }
+        retire();
+        is_fitted = true;
+    }
+
+protected:
+    /**
+     * @brief  Processes the elements X[begin], ..., X[end - 1] group by group instead of element by element: All pool_rows of the block are computed upfront and each group then consumes the entire block while its state is hot in the cache (see SieveBank::run_block). Groups are independent of each other, hence the state of each group is the same as with `next`. The best solution is tracked per group along with the position in the block at which it was reached, so that the overall best solution is also the same.
+     */
+    void next_block(std::vector<std::vector<data_t>> const &X, std::vector<idx_t> const & X_ids, unsigned int begin, unsigned int end) {
+        // In the parallel mode the groups are evaluated element by element. If all groups are retired, there is nothing to gain from blocks.
+        if (threads.size() > 1 || end - begin < 2 || bank.size() == 0) {
+            SubmodularOptimizer::next_block(X, X_ids, begin, end);
+            return;
+        }
+
+        bank.start_block(X, begin, end);
+        bank.run_block(X, X_ids, begin, 0, std::numeric_limits<data_t>::infinity());
+        bank.end_block();
+
+        // Solutions only grow, hence the solution at that time is a prefix of the current one
+        int best = bank.best_in_block(fval);
+        if (best >= 0) {
+            SieveBank::Summary const & s = bank.get_summary(best);
+            SieveBank::Progress const & p = bank.get_progress(best);
+            fval = p.fval;
+            solution.assign(s.solution.begin(), s.solution.begin() + p.size);
+            ids.assign(s.ids.begin(), s.ids.begin() + p.num_ids);
         }
+        retire();
         is_fitted = true;
     }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -3,9 +3,11 @@
 
 #include "DataTypeHandling.h"
 #include "SieveStreaming.h"
+#include "SieveBank.h"
+#include "ThreadPool.h"
 #include <vector>
 #include <algorithm>
-#include <numeric>
+#include <limits>
 #include <unordered_set>
 
 /**
@@ -46,7 +48,7 @@
  *  summary = opt.get_solution()
  * @endcode
  * 
- * @note Since this is an extension of SieveStreaming it seems likely that this class should be an extension of SieveStreaming. However, I decided against this, since the actual benefit by this is minimal. The `fit` is substantially different from SieveStreaming and the internal Sieve class uses a slightly different thresholding rule. Thus I decided to separate both implementations.  
+ * @note Since this is an extension of SieveStreaming it seems likely that this class should be an extension of SieveStreaming. However, I decided against this, since the actual benefit by this is minimal. The `fit` is substantially different from SieveStreaming and the sieves use a slightly different thresholding rule. Thus both implementations are separated and only share the sieves themselves (see SieveBank).  
  * 
  * __References__
  * 
@@ -54,66 +56,10 @@
 
 */
 class SieveStreamingPP : public SubmodularOptimizer {
-private:
+protected:
 
-    /**
-     * @brief  A single sieve with its own threshold and accompanying summary.  
-     * @note   This class is basically also implemented in SieveStreaming and - to some extend - in Salsa. I decided against a unified class for these Sieves, since the thresholding rules are often slightly different from paper to paper. I tried to stick as close as possible to the pseudocode in the papers.
-     */
-    class Sieve : public SubmodularOptimizer {
-        public:
-            // The threshold
-            data_t threshold;
-
-            /**
-             * @brief Construct a new Sieve object
-             * 
-             * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-             * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.  
-             * @param threshold The threshold.
-             */
-            Sieve(unsigned int K, SubmodularFunction & f, data_t threshold) : SubmodularOptimizer(K,f), threshold(threshold) {}
-
-            /**
-             * @brief Construct a new Sieve object
-             * 
-             * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
-             * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state.
-             * @param threshold The threshold.
-             */
-            Sieve(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t threshold) : SubmodularOptimizer(K,f), threshold(threshold) {
-            }
-
-            /**
-             * @brief Throws an exception since fit() should not be used directly here. Sieves are not meant to be used on their own, but only through SieveStreaming.
-             * 
-             * @param X A constant reference to the entire data set
-             */
-            void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
-                throw std::runtime_error("Sieves are only meant to be used through SieveStreaming and therefore do not require the implementation of `fit'");
-            }
-
-            /**
-             * @brief  Consume the next object in the data stream. This call compares the marginal gain against the given threshold and add the current item to the current solution if it exceeds the given threshold. 
-             * 
-             * @param  &x: A constant reference to the next object on the stream.
-             * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
-             */
-            void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-                unsigned int Kcur = solution.size();
-                if (Kcur < K) {
-                    data_t fdelta = f->peek(solution, x, solution.size()) - fval;
-
-                    if (fdelta >= threshold) {
-                        f->update(solution, x, solution.size());
-                        solution.push_back(x);
-                        if (id.has_value()) ids.push_back(id.value());
-                        fval += fdelta;
-                    }
-                }
-                is_fitted = true;
-            }
-        };    
+    // All sieves. Sieves which accepted the same elements share their summary and their function state. Since every sieve accepts an element if its gain is at least the threshold, the sieves of a group which accept an element always form a prefix of its (sorted) thresholds.
+    SieveBank bank;
 
     // The lower bound from which threshold should be sampled. This is per default 0 and will be changed when a new, better lower_bound occurs
     data_t lower_bound;
@@ -124,10 +70,43 @@ private:
     // Epsilon parameter used to sample thresholds according to the "SieveStreaming" rule
     data_t epsilon;
 
-public:
-    // The list of sieves managed by SieveStreamingPP
-    std::vector<std::unique_ptr<Sieve>> sieves;
+    // The threads which evaluate the groups in parallel
+    ThreadPool threads;
+
+    /**
+     * @brief  Returns the acceptance rule of a sieve: An element is accepted if its gain is at least the threshold of the sieve.
+     */
+    static SieveBank::Rule rule(data_t threshold, unsigned int) {
+        return {threshold, threshold, std::numeric_limits<data_t>::infinity()};
+    }
+
+    /**
+     * @brief  Removes all sieves whose threshold is below the current lower bound and samples new sieves if the lower bound changed. The new sieves, whose thresholds are not used by any sieve yet, form a new group with an empty summary.
+     * @param  cursor: The position in the current block at which new sieves start (see next_block).
+     */
+    void update_sieves(unsigned int cursor = 0) {
+        if (lower_bound != fval || bank.num_sieves() == 0) {
+            lower_bound = fval;
+            data_t tau_min = std::max(lower_bound, m) / static_cast<data_t>(2.0*K);
+            auto no_sieves_before = bank.num_sieves();
+            bank.erase_below(tau_min);
+
+            if (no_sieves_before > bank.num_sieves() || no_sieves_before == 0) {
+                std::vector<data_t> existing = bank.get_thresholds();
+                std::sort(existing.begin(), existing.end());
+
+                std::vector<data_t> ts;
+                for (auto t : thresholds(tau_min/(1.0 + epsilon), K * m, epsilon)) {
+                    if (!std::binary_search(existing.begin(), existing.end(), t)) {
+                        ts.push_back(t);
+                    }
+                }
+                bank.add(ts, std::vector<unsigned int>(ts.size(), 0), cursor);
+            }
+        }
+    }
 
+public:
     /**
      * @brief Construct a new SieveStreamingPP object
      * 
@@ -135,15 +114,10 @@ public:
      * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.  
      * @param m The maximum value of the singleton set, \f$ m = max_e f({e}) \f$
      * @param epsilon The sampling accuracy for threshold generation
+     * @param num_threads The number of threads which evaluate the sieves in parallel. If this is 0, then one thread per core is used. Note, that all sieves share the same function if it is passed as std::function, which then must be thread-safe.
      */
-    SieveStreamingPP(unsigned int K, SubmodularFunction & f, data_t m, data_t epsilon) 
-        : SubmodularOptimizer(K,f), lower_bound(0), m(m), epsilon(epsilon) {
-            // std::vector<data_t> ts = thresholds(m/(1.0 + epsilon), K * m, epsilon);
-
-            // for (auto t : ts) {
-            //     sieves.push_back(std::make_unique<Sieve>(K, *this->f, t));
-            // }
-        }
+    SieveStreamingPP(unsigned int K, SubmodularFunction & f, data_t m, data_t epsilon, unsigned int num_threads = 1) 
+        : SubmodularOptimizer(K,f), bank(K, this->f, false, rule), lower_bound(0), m(m), epsilon(epsilon), threads(num_threads) {}
 
     /**
      * @brief Construct a new SieveStreamingPP object
@@ -152,33 +126,23 @@ public:
      * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if f keeps track of a state. 
      * @param m The maximum value of the singleton set, \f$ m = max_e f({e}) \f$
      * @param epsilon The sampling accuracy for threshold generation
+     * @param num_threads The number of threads which evaluate the sieves in parallel. If this is 0, then one thread per core is used. Note, that all sieves share the same function if it is passed as std::function, which then must be thread-safe.
      */
-    SieveStreamingPP(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t m, data_t epsilon) 
-        : SubmodularOptimizer(K,f), lower_bound(0), m(m), epsilon(epsilon) {
-            // std::vector<data_t> ts = thresholds(m/(1.0 + epsilon), K * m, epsilon);
-
-            // for (auto t : ts) {
-            //     sieves.push_back(std::make_unique<Sieve>(K, *this->f, t));
-            // }
-        }
+    SieveStreamingPP(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t m, data_t epsilon, unsigned int num_threads = 1) 
+        : SubmodularOptimizer(K,f), bank(K, this->f, false, rule), lower_bound(0), m(m), epsilon(epsilon), threads(num_threads) {}
 
     /**
-     * @brief  Returns the number of sieves.
+     * @brief  Returns the number of distinct candidate solutions. Sieves which accepted the same elements share their solution and are counted once.
      */
     unsigned int get_num_candidate_solutions() const {
-        return sieves.size();
+        return bank.size();
     }
 
     /**
-     * @brief  Returns the total number of items stored across all sieves.
+     * @brief  Returns the total number of items stored across all (distinct) candidate solutions.
      */
     unsigned long get_num_elements_stored() const {
-        unsigned long num_elements = 0;
-        for (auto const & s : sieves) {
-            num_elements += s->get_solution().size();
-        }
-
-        return num_elements;
+        return bank.get_num_elements_stored();
     }
 
     /**
@@ -188,41 +152,64 @@ public:
      * @param  id: The id of the given object. If this is a `std::nullopt` this parameter is ignored. Otherwise the id is inserted into the solution. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.  
      */
     void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
-        if (lower_bound != fval || sieves.size() == 0) {
-            lower_bound = fval;
-            data_t tau_min = std::max(lower_bound, m) / static_cast<data_t>(2.0*K);
-            auto no_sieves_before = sieves.size();
-
-            auto res = std::remove_if(sieves.begin(), sieves.end(), 
-                [tau_min](auto const &s) { return s->threshold < tau_min; }
-            );
-            sieves.erase(res, sieves.end());
-
-            if (no_sieves_before > sieves.size() || no_sieves_before == 0) {
-                std::vector<data_t> ts = thresholds(tau_min/(1.0 + epsilon), K * m, epsilon);
-                
-                for (auto t : ts) {
-                    bool any = std::any_of(sieves.begin(), sieves.end(), 
-                        [t](auto const &s){ return s->threshold == t; }
-                    );
-                    if (!any) {
-                        sieves.push_back(std::make_unique<Sieve>(K, *f, t));
-                    }
+        update_sieves();
+        bank.next(x, id, 0, threads);
+
+        int best = bank.best(fval);
+        if (best >= 0) {
+            fval = bank.get_fval(best);
+            solution = bank.get_summary(best).solution;
+            ids = bank.get_summary(best).ids;
+        }
+        is_fitted = true;
+    };
+
+protected:
+    /**
+     * @brief  Processes the elements X[begin], ..., X[end - 1] group by group instead of element by element. All pool_rows of the block are computed upfront. Unlike SieveStreaming, the sieves depend on each other through the lower bound fval which decides which sieves exist. The block is therefore processed in epochs: Each group consumes the block until its fval exceeds the current fval (see SieveBank::run_block). The earliest such position ends the epoch, fval is updated as `next` would have at this position and the sieves are re-sampled before the next epoch starts. Groups only depend on their own state, hence groups which went past this position can simply continue later. The result is the same as with `next`.
+     */
+    void next_block(std::vector<std::vector<data_t>> const &X, std::vector<idx_t> const & X_ids, unsigned int begin, unsigned int end) {
+        // In the parallel mode the groups are evaluated element by element
+        if (threads.size() > 1 || end - begin < 2) {
+            SubmodularOptimizer::next_block(X, X_ids, begin, end);
+            return;
+        }
+
+        bank.start_block(X, begin, end);
+        unsigned int B = end - begin;
+        unsigned int e = 0;
+        while (e < B) {
+            update_sieves(e);
+
+            // Groups whose fval exceeds fval are waiting for an earlier epoch to end, all others consume the block until they do
+            bank.run_block(X, X_ids, begin, 0, fval);
+
+            unsigned int first = B;
+            for (unsigned int g = 0; g < bank.size(); ++g) {
+                if (bank.get_fval(g) > fval) {
+                    first = std::min(first, bank.get_progress(g).pos);
                 }
             }
-        }
 
-        // std::cout << sieves.size() << std::endl;
-        for (auto &s : sieves) {
-            s->next(x, id);
-            if (s->get_fval() > fval) {
-                fval = s->get_fval();
-                // TODO THIS IS A COPY AT THE MOMENT
-                solution = s->solution;
+            if (first == B) {
+                break;
+            }
+
+            int best = -1;
+            for (unsigned int g = 0; g < bank.size(); ++g) {
+                data_t gval = bank.get_fval(g);
+                if (gval > fval && bank.get_progress(g).pos == first && (best < 0 || gval > bank.get_fval(best) || (gval == bank.get_fval(best) && bank.before(g, best)))) {
+                    best = g;
+                }
             }
+            fval = bank.get_fval(best);
+            solution = bank.get_summary(best).solution;
+            ids = bank.get_summary(best).ids;
+            e = first + 1;
         }
+        bank.end_block();
         is_fitted = true;
-    };
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
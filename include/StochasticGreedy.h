@@ -0,0 +1,153 @@
+#ifndef STOCHASTIC_GREEDY_H
+#define STOCHASTIC_GREEDY_H
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cmath>
+
+/**
+ * @brief  The StochasticGreedy optimizer for monotone submodular functions. Instead of rating all remaining elements in each round like Greedy, it only rates a random sample of size \f$ s = \lceil N / K \cdot \log(1 / \varepsilon) \rceil\f$ and picks the element with the largest gain in that sample. This process is repeated until K elements have been selected. Mirzasoleiman et al. showed, that this gives a \f$ 1 - 1/\exp(1) - \varepsilon\f$ approximation in expectation with only \f$ O(N \log(1/\varepsilon)) \f$ function queries in total, independent of K. If the sample is larger than the number of remaining elements, then all of them are rated as in Greedy.
+ *  - Stream:  No
+ *  - Solution: \f$ 1 - 1/\exp(1) - \varepsilon \f$ in expectation
+ *  - Runtime: \f$ O(N \cdot \log(1/\varepsilon)) \f$
+ *  - Memory: \f$ O(N) \f$
+ *  - Function Queries per Element: \f$ O(\log(1/\varepsilon) / K) \f$ per round
+ *  - Function Types: nonnegative, monotone submodular functions
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  //read some data
+ *  std::vector<std::vector<data_t>> = read_some_data();
+ *  auto K = 50;
+ *  // Define the function to be maximized and select the summary
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(data[0].size()), 1.0) , 1.0);
+ *  StochasticGreedy opt(K, fastIVM, 0.01);
+ *  opt.fit(data);
+ *  std::cout << "fval:" << opt.get_fval() << "num_elements: " << opt.get_num_elements_stored() << "num_candidates: " << opt.get_num_candidate_solutions() << std::endl;
+ *  // Process summary
+ *  auto summary = opt.get_solution();
+ * @endcode
+ *
+ * Example usage in Python:
+ * @code{.py}
+ *  X = read_some_data();
+ *  K = 50
+ *  # Create function to be maximized
+ *  kernel = RBFKernel(sigma=sigma,scale=scale)
+ *  fastLogDet = FastIVM(K, kernel, 1.0)
+ *  opt = StochasticGreedy(K, fastLogDet, 0.01)
+ *  opt.fit(X, K)
+ *  print("fval: {} num_elements: {} num_candidates: {}".format(opt.get_fval(), opt.get_num_elements_stored(), opt.get_num_candidate_solutions()))
+ *  # process summary
+ *  summary = opt.get_solution()
+ * @endcode
+ *
+ * __References__
+ *
+ * - Mirzasoleiman, B., Badanidiyuru, A., Karbasi, A., Vondrák, J., & Krause, A. (2015). Lazier Than Lazy Greedy. In Proceedings of the AAAI Conference on Artificial Intelligence. https://doi.org/10.1609/aaai.v29i1.9486
+ */
+class StochasticGreedy : public SubmodularOptimizer {
+protected:
+    // The accuracy parameter which determines the size of the sample in each round
+    data_t epsilon;
+
+    std::default_random_engine generator;
+
+public:
+
+    /**
+     * @brief Construct a new StochasticGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object. If you implement a custom SubmodularFunction make sure that everything you need is actually cloned / copied.
+     * @param epsilon The accuracy parameter. Smaller values lead to larger samples and better solutions.
+     * @param seed The random seed used for sampling.
+     */
+    StochasticGreedy(unsigned int K, SubmodularFunction & f, data_t epsilon, unsigned long seed = 0) : SubmodularOptimizer(K,f), epsilon(epsilon), generator(seed) {}
+
+    /**
+     * @brief Construct a new StochasticGreedy object
+     *
+     * @param K The cardinality constraint you of the optimization problem, that is the number of items selected.
+     * @param f The function which should be maximized. Note, that this parameter is likely moved and not copied. Thus, if you construct multiple optimizers with the __same__ function they all reference the __same__ function. This can be very efficient for state-less functions, but may lead to weird side effects if `f` keeps track of a state.
+     * @param epsilon The accuracy parameter. Smaller values lead to larger samples and better solutions.
+     * @param seed The random seed used for sampling.
+     */
+    StochasticGreedy(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f, data_t epsilon, unsigned long seed = 0) : SubmodularOptimizer(K,f), epsilon(epsilon), generator(seed) {}
+
+    /**
+     * @brief Sample a random set of remaining elements and pick that element with the largest marginal gain in the sample. Repeat this until K element have been selected. You can access the solution via `get_solution` and the corresponding ids (if passed) with `get_ids()`
+     *
+     * @param X A constant reference to the entire data set
+     * @param ids: A list of identifier for each object. This can be used to uniquely identify the objects in the summary. If ids.size() < X.size(), then only partial ids are stored. No ids are stored if ids is empty. Make sure, that either _all_ or _no_ object receives an id to keep track which id belongs to which object. This algorithm simply stores the objects and the ids in two separate lists and performs no safety checks.
+     * @param iterations: Has no effect. StochasticGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int iterations = 1) {
+        std::vector<unsigned int> remaining(X.size());
+        std::iota(remaining.begin(), remaining.end(), 0);
+
+        unsigned long sample_size = static_cast<unsigned long>(std::ceil(static_cast<data_t>(X.size()) / K * std::log(1.0 / epsilon)));
+        sample_size = std::max(sample_size, 1ul);
+
+        data_t fcur = 0;
+        std::vector<unsigned int> candidates;
+        std::vector<data_t> fvals;
+        while(solution.size() < K && remaining.size() > 0) {
+            // Partial Fisher-Yates shuffle, so that the sample is at the front of remaining. 
+            unsigned int m = std::min(sample_size, static_cast<unsigned long>(remaining.size()));
+            if (m < remaining.size()) {
+                for (unsigned int i = 0; i < m; ++i) {
+                    unsigned int j = std::uniform_int_distribution<unsigned int>(i, remaining.size() - 1)(generator);
+                    std::swap(remaining[i], remaining[j]);
+                }
+            }
+
+            // Sort the sample so that ties are broken towards the smaller index as in Greedy
+            candidates.assign(remaining.begin(), remaining.begin() + m);
+            std::sort(candidates.begin(), candidates.end());
+
+            f->peek_batch(solution, X, candidates, fvals);
+            unsigned int max_element = std::distance(fvals.begin(),std::max_element(fvals.begin(), fvals.end()));
+            fcur = fvals[max_element];
+            unsigned int max_idx = candidates[max_element];
+
+            f->update(solution, X[max_idx], solution.size());
+            solution.push_back(X[max_idx]);
+            if (max_idx < ids.size()) {
+                this->ids.push_back(ids[max_idx]);
+            }
+            // The order of the remaining elements does not matter, hence we swap the selected element to the back
+            auto it = std::find(remaining.begin(), remaining.begin() + m, max_idx);
+            std::swap(*it, remaining.back());
+            remaining.pop_back();
+        }
+
+        fval = fcur;
+        is_fitted = true;
+    }
+
+    /**
+     * @brief Sample a random set of remaining elements and pick that element with the largest marginal gain in the sample. Repeat this until K element have been selected. You can access the solution via `get_solution`
+     * @note This internally calls fit with an empty id set.
+     * @param X A constant reference to the entire data set
+     * @param iterations: Has no effect. StochasticGreedy selects K elements in any case.
+     */
+    void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
+        fit(X,ids,iterations);
+    }
+
+    /**
+     * @brief Throws an exception when called. StochasticGreedy does not support streaming!
+     *
+     * @param x A constant reference to the next object on the stream.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> id = std::nullopt) {
+        throw std::runtime_error("StochasticGreedy does not support streaming data, please use fit().");
+    }
+};
+
+#endif // STOCHASTIC_GREEDY_H
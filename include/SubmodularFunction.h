@@ -1,12 +1,14 @@
 #ifndef SUBMODULARFUNCTION_H
 #define SUBMODULARFUNCTION_H
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 #include <functional>
 #include <cassert>
+#include <limits>
 
 #include "DataTypeHandling.h"
 
@@ -36,6 +38,56 @@ public:
      */
     virtual data_t peek(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) = 0; 
 
+    /**
+     * @brief  Returns the function values if any of the candidates X[candidates[0]], X[candidates[1]], ... __would__ be appended to the current solution. This is the same as calling `peek(cur_solution, X[candidates[i]], cur_solution.size())` for each candidate, which is exactly what the default implementation does. Submodular functions can override this method to share work between the candidates, e.g. by processing them as a block.
+     * @note   
+     * @param  cur_solution: The current solution.
+     * @param  X: The data set from which the candidates are taken.
+     * @param  candidates: The indices of the candidates in X.
+     * @param  fvals: The function values for each candidate. fvals is resized to candidates.size(), so that fvals[i] belongs to X[candidates[i]].
+     * @retval None
+     */
+    virtual void peek_batch(std::vector<std::vector<data_t>> const &cur_solution, std::vector<std::vector<data_t>> const &X, std::vector<unsigned int> const &candidates, std::vector<data_t> &fvals) {
+        fvals.resize(candidates.size());
+        for (unsigned int i = 0; i < candidates.size(); ++i) {
+            fvals[i] = peek(cur_solution, X[candidates[i]], cur_solution.size());
+        }
+    }
+
+    /**
+     * @brief  Computes everything about x which depends on a single stored element only (e.g. the kernel values k(x, e)) for all elements of a pool at once. Multi-sieve optimizers store the distinct elements of all sieves in an ElementPool, call this function once per new element and pass the result to `peek_pooled` of each sieve. The default implementation computes nothing and leaves row empty.
+     * @param  pool: Pointers to the elements of the pool indexed by their slot. Unused slots are nullptr and can be ignored.
+     * @param  x: The item which we would hypothetically add to the solutions.
+     * @param  row: The output which is later passed to `peek_pooled`. 
+     */
+    virtual void pool_row(std::vector<std::vector<data_t> const *> const &pool, std::vector<data_t> const &x, std::vector<data_t> &row) {
+        row.clear();
+    }
+
+    /**
+     * @brief  Same as `peek`, but may use the row computed by `pool_row` for the same x. The default implementation ignores row and calls `peek`.
+     * @param  cur_solution: The current solution.
+     * @param  x: The item which we would hypothetically add to the solution.
+     * @param  pos: The position at which we would add x. 
+     * @param  row: The output of `pool_row` for x.
+     * @param  pool_ids: The slot of each element of cur_solution in the pool, i.e. *pool[pool_ids[i]] == cur_solution[i].
+     * @retval The function value if we would add x to cur_solution at position pos 
+     */
+    virtual data_t peek_pooled(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos, std::vector<data_t> const &row, std::vector<unsigned int> const &pool_ids) {
+        return peek(cur_solution, x, pos);
+    }
+
+    /**
+     * @brief  Returns an upper bound on the gain `peek(cur_solution, x, cur_solution.size()) - f(cur_solution)` if x __would__ be appended to the current solution. Optimizers can use this bound to skip the (possibly expensive) call to `peek` if the bound is already smaller than the threshold an element must exceed. The bound must never be smaller than the actual gain, otherwise the optimizers behave differently. The default implementation returns infinity, so that `peek` is always called.
+     * @note   
+     * @param  cur_solution: The current solution.
+     * @param  x: The item which we would hypothetically add to the solution.
+     * @retval An upper bound on the gain of x.
+     */
+    virtual data_t gain_upper_bound(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x) {
+        return std::numeric_limits<data_t>::infinity();
+    }
+
     /**
      * @brief  Update the function if we add x at position "pos" to the current solution. If pos is greater than the number of elements in the current solution we add x the current solution. Otherwise, we replace the object at position "pos" with x.
      * @note   
@@ -46,6 +98,16 @@ public:
      */
     virtual void update(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) = 0;
 
+    /**
+     * @brief  Update the function if we remove the object at position "pos" from the current solution. All objects after pos move one position to the front. This allows e.g. windowed or deletion-robust summarizers to expire elements without re-building the function from scratch. The default implementation throws an exception since a generic function cannot undo its updates. 
+     * @param  cur_solution: The current solution before the object is removed.
+     * @param  pos: The position of the object which is removed. Note that it holds: \f$ 0 \le pos < cur\_solution.size() \f$
+     * @retval None
+     */
+    virtual void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) {
+        throw std::runtime_error("This SubmodularFunction does not support the removal of elements.");
+    }
+
     /**
      * @brief  This function returns a clone of this Submodular function. Make sure, that the new objet is a valid clone which behaves like a new object and does not reference any members of this object. Some algorithms like SieveStreaming(++) or Salsa utilize multiple optimizers in parallel each with their own unique SubmodularFunction. Moreover, to make for efficient PyBind bindings, we use clone() to give the C++ side more control over the memory.   
      * @note   
@@ -53,6 +115,22 @@ public:
      */
     virtual std::shared_ptr<SubmodularFunction> clone() const = 0;
 
+    /**
+     * @brief  Returns a copy of this function which has the same state as this object, i.e. as if `update` has been called for every element in cur_solution. Afterwards, both objects can be updated independently. This is used e.g. by SieveStreaming to share a single state between multiple sieves which only copy it once their solutions diverge. The default implementation clones the function and replays all updates. Stateful functions should override this with a cheaper (deep) copy.
+     * @param  cur_solution: The current solution.
+     * @retval The copied object.
+     */
+    virtual std::shared_ptr<SubmodularFunction> copy(std::vector<std::vector<data_t>> const &cur_solution) const {
+        std::shared_ptr<SubmodularFunction> f = clone();
+        std::vector<std::vector<data_t>> prefix;
+        prefix.reserve(cur_solution.size());
+        for (auto const & x : cur_solution) {
+            f->update(prefix, x, prefix.size());
+            prefix.push_back(x);
+        }
+        return f;
+    }
+
     /**
      * @brief  Destroys this object
      * @note   
@@ -121,6 +199,14 @@ public:
      * @retval None
      */
     void update(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) {}
+
+    /**
+     * @brief  Implements the remove method. This class is state-less, so we don't do anything here.
+     * @param  &cur_solution: 
+     * @param  pos: 
+     * @retval None
+     */
+    void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) {}
     
     /**
      * @brief  Implements the clone method. Note, that it is very likely that the std::function `f' has been moved into this object and similarly, we will move it into the clone as-well. This is okay, as long as `f' is a stateless function. However, if `f' has some internal state, then the other optimizers will use the __same__ function with the shared state which will probably lead to weird side-effects. In this case consider implementing a proper SubmodularFunction.  
@@ -138,4 +224,108 @@ public:
     ~SubmodularFunctionWrapper() {}
 };
 
+/**
+ * @brief  A wrapper around a raw C function pointer with the signature `data_t f(data_t const * X, idx_t n, idx_t dim)` where X points to a row-major \f$ n \times dim \f$ array holding the current solution. Similar to the SubmodularFunctionWrapper this is meant for stateless functions. In contrast to the SubmodularFunctionWrapper, the function pointer is called directly which makes it possible to use native code from other languages such as `numba.cfunc` or `ctypes` callbacks from Python without a round-trip through the Python interpreter for every function query.
+ * @note   The solution is copied into a contiguous buffer before each call. This buffer is owned by this object and re-used between calls.
+ */
+class NativeSubmodularFunction : public SubmodularFunction {
+public:
+    // The signature of a native submodular function. The first argument points to the row-major data of the solution, the second / third argument are the number of rows / columns.
+    typedef data_t (*function_ptr)(data_t const *, idx_t, idx_t);
+
+protected:
+    // The wrapped function pointer.
+    function_ptr f;
+
+    // Contiguous buffer used during peek to avoid re-allocations
+    std::vector<data_t> buffer;
+
+    /**
+     * @brief  Copies the given solution into the contiguous buffer. If x is given, then it is either appended to the solution (pos >= cur_solution.size()) or replaces the element at position pos.
+     * @param  &cur_solution: The current solution.
+     * @param  x: The item which we would hypothetically add to the solution. Can be a nullptr.
+     * @param  pos: The position at which x is inserted.
+     * @param  &out: The buffer to copy the solution into.
+     * @retval The number of rows in the buffer
+     */
+    static idx_t flatten(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const * x, unsigned int pos, std::vector<data_t> & out) {
+        idx_t dim = cur_solution.size() > 0 ? cur_solution[0].size() : (x != nullptr ? x->size() : 0);
+        idx_t n = cur_solution.size();
+        if (x != nullptr && pos >= cur_solution.size()) ++n;
+
+        out.resize(n * dim);
+        for (unsigned int i = 0; i < cur_solution.size(); ++i) {
+            std::vector<data_t> const & row = (x != nullptr && i == pos) ? *x : cur_solution[i];
+            std::copy(row.begin(), row.end(), out.begin() + i * dim);
+        }
+        if (x != nullptr && pos >= cur_solution.size()) {
+            std::copy(x->begin(), x->end(), out.begin() + cur_solution.size() * dim);
+        }
+        return n;
+    }
+
+public:
+
+    /**
+     * @brief  Creates a new SubmodularFunction from a given function pointer.
+     * @param  f: The (stateless) function pointer which implements the actual submodular function. Must not be a nullptr.
+     */
+    NativeSubmodularFunction(function_ptr f) : f(f) {
+        assert(("The function pointer of a NativeSubmodularFunction should not be a nullptr!", f != nullptr));
+    }
+
+    /**
+     * @brief  Copies cur_solution into a contiguous array and calls the function pointer.
+     * @param  &cur_solution: The current solution.
+     * @retval The function value of the current solution.
+     */
+    data_t operator()(std::vector<std::vector<data_t>> const &cur_solution) const override {
+        std::vector<data_t> tmp;
+        idx_t n = flatten(cur_solution, nullptr, 0, tmp);
+        return f(tmp.data(), n, n > 0 ? tmp.size() / n : 0);
+    }
+
+    /**
+     * @brief  Implements the peek method. This copies the current solution into a contiguous buffer, adds x at the appropriate positon and calls the function pointer.
+     * @param  &cur_solution: The current solution.
+     * @param  &x: The item which we would hypothetically add to the solution.
+     * @param  pos: The position at which we would add x.
+     * @retval The function value if we would add x to cur_solution at position pos
+     */
+    data_t peek(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) override {
+        idx_t n = flatten(cur_solution, &x, pos, buffer);
+        return f(buffer.data(), n, x.size());
+    }
+
+    /**
+     * @brief  The wrapped function pointer is stateless. Thus, we don't do anything here.
+     * @param  &cur_solution:
+     * @param  &x:
+     * @param  pos:
+     * @retval None
+     */
+    void update(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) override {}
+
+    /**
+     * @brief  The wrapped function pointer is stateless. Thus, we don't do anything here.
+     * @param  &cur_solution:
+     * @param  pos:
+     * @retval None
+     */
+    void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) override {}
+
+    /**
+     * @brief  Implements the clone method. Only the function pointer is copied.
+     * @retval The cloned object.
+     */
+    std::shared_ptr<SubmodularFunction> clone() const override {
+        return std::shared_ptr<SubmodularFunction>(new NativeSubmodularFunction(f));
+    }
+
+    /**
+     * @brief  Destroy the wrapper object.
+     */
+    ~NativeSubmodularFunction() {}
+};
+
 #endif // SUBMODULARFUNCTION_H
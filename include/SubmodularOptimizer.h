@@ -9,6 +9,7 @@
 #include <cassert>
 #include <memory>
 #include <optional>
+#include <algorithm>
 
 #include "SubmodularFunction.h"
 
@@ -38,6 +39,26 @@ protected:
     // true if fit() or next() has been called.
     bool is_fitted;
 
+    // The number of elements which are passed to next_block at once during the first iteration of fit
+    static constexpr unsigned int block_size = 128;
+
+    /**
+     * @brief  Consume the objects X[begin], ..., X[end - 1] of the data stream in this order. This must have the same result as calling `next` for each object. The default implementation does exactly this. Optimizers with many candidate solutions (e.g. SieveStreaming) can override this to process the block candidate-by-candidate, so that the state of each candidate stays in the cache while it processes the entire block.
+     * @param  X: A constant reference to the data.
+     * @param  ids: The ids of the objects. The id ids[j] is used for X[j] if j < ids.size().
+     * @param  begin: The first object of the block.
+     * @param  end: One past the last object of the block.
+     */
+    virtual void next_block(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int begin, unsigned int end) {
+        for (unsigned int j = begin; j < end; ++j) {
+            if (j < ids.size()) {
+                next(X[j], ids[j]);
+            } else {
+                next(X[j]);
+            }
+        }
+    }
+
 public:
     // The current solution of this optimizer
     std::vector<std::vector<data_t>> solution;
@@ -84,6 +105,14 @@ public:
         assert(X.size() == ids.size());
 
         for (unsigned int i = 0; i < iterations; ++i) {
+            if (i == 0) {
+                // There is no early exit in the first iteration, hence we can process the data in blocks
+                for (unsigned int j = 0; j < X.size(); j += block_size) {
+                    next_block(X, ids, j, std::min(static_cast<unsigned int>(X.size()), j + block_size));
+                }
+                continue;
+            }
+
             for (unsigned int j = 0; j < X.size(); ++j) {
                 next(X[j], ids[j]);
                 // It is very likely that the lower threshold sieves will fill up early and thus we will probably find a full sieve early on
@@ -105,7 +134,16 @@ public:
      * @retval None
      */
     virtual void fit(std::vector<std::vector<data_t>> const & X, unsigned int iterations = 1) {
+        std::vector<idx_t> ids;
         for (unsigned int i = 0; i < iterations; ++i) {
+            if (i == 0) {
+                // There is no early exit in the first iteration, hence we can process the data in blocks
+                for (unsigned int j = 0; j < X.size(); j += block_size) {
+                    next_block(X, ids, j, std::min(static_cast<unsigned int>(X.size()), j + block_size));
+                }
+                continue;
+            }
+
             for (auto &x : X) {
                 next(x);
                 // It is very likely that the lower threshold sieves will fill up early and thus we will probably find a full sieve early on
@@ -127,6 +165,18 @@ public:
      */
     virtual void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) = 0;
 
+    /**
+     * @brief  Consume the next block of objects in the data stream. This has the same result as calling `next` for each object in order, but may be much faster for optimizers with many candidate solutions (e.g. SieveStreaming, SieveStreamingPP), since they process the block candidate-by-candidate. This may throw an exception if the optimizer does not support streaming.
+     * @param  X: A constant reference to the block of objects.
+     * @param  ids: The ids of the objects. If ids.size() < X.size(), then only the first ids.size() objects receive an id. No ids are used if ids is empty.
+     * @retval None
+     */
+    void next_batch(std::vector<std::vector<data_t>> const &X, std::vector<idx_t> const & ids = {}) {
+        for (unsigned int j = 0; j < X.size(); j += block_size) {
+            next_block(X, ids, j, std::min(static_cast<unsigned int>(X.size()), j + block_size));
+        }
+    }
+
 
     /**
      * @brief  Return the current solution.
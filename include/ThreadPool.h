@@ -0,0 +1,168 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+#include <algorithm>
+
+/**
+ * @brief  A minimal fork-join thread pool. The threads are started once and then wait for work, so that optimizers can distribute work in every round (e.g. every iteration of Greedy) without the overhead of creating new threads. `run(task)` executes task(0), ..., task(size() - 1) in parallel and blocks until all of them are finished. The calling thread executes task(0) itself.
+ */
+class ThreadPool {
+private:
+    // The worker threads. Worker i executes task(i + 1).
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+
+    // The current task and a counter which is increased for every new task
+    std::function<void(unsigned int)> const * task;
+    unsigned long generation;
+
+    // The number of workers which did not finish the current task yet
+    unsigned int pending;
+
+    // True if the pool is destroyed
+    bool stop;
+
+    // The first exception thrown by any of the workers during the current task
+    std::exception_ptr error;
+
+    /**
+     * @brief  The main loop of each worker thread.
+     * @param  id: The id of this worker which is passed to the task.
+     */
+    void work(unsigned int id) {
+        unsigned long seen = 0;
+        while (true) {
+            std::function<void(unsigned int)> const * cur;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                start.wait(lock, [&]{ return stop || generation != seen; });
+                if (stop) {
+                    return;
+                }
+                seen = generation;
+                cur = task;
+            }
+
+            std::exception_ptr e;
+            try {
+                (*cur)(id);
+            } catch (...) {
+                e = std::current_exception();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (e && !error) {
+                    error = e;
+                }
+                if (--pending == 0) {
+                    done.notify_one();
+                }
+            }
+        }
+    }
+
+public:
+
+    /**
+     * @brief  Creates a new thread pool.
+     * @param  num_threads: The number of threads including the calling thread. If this is 0, then std::thread::hardware_concurrency() threads are used.
+     */
+    ThreadPool(unsigned int num_threads = 0) : task(nullptr), generation(0), pending(0), stop(false) {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (unsigned int i = 1; i < num_threads; ++i) {
+            workers.emplace_back(&ThreadPool::work, this, i);
+        }
+    }
+
+    ThreadPool(ThreadPool const &) = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+
+    /**
+     * @brief  Returns the number of threads including the calling thread.
+     */
+    unsigned int size() const {
+        return workers.size() + 1;
+    }
+
+    /**
+     * @brief  Executes f(0), ..., f(size() - 1) in parallel and waits until all calls are finished. If any call throws an exception, then the first exception is re-thrown after all calls are finished.
+     * @param  f: The task. It receives the id of the thread in [0, size()).
+     */
+    void run(std::function<void(unsigned int)> const & f) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task = &f;
+            pending = workers.size();
+            error = nullptr;
+            ++generation;
+        }
+        start.notify_all();
+
+        std::exception_ptr e;
+        try {
+            f(0);
+        } catch (...) {
+            e = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&]{ return pending == 0; });
+        if (e) {
+            std::rethrow_exception(e);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /**
+     * @brief  Executes f(0), ..., f(n - 1) in parallel and waits until all calls are finished. The indices are handed out dynamically via an atomic counter, so that expensive and cheap calls are balanced across the threads. If the pool only has a single thread, then the calls are executed in order by the calling thread.
+     * @param  n: The number of calls.
+     * @param  f: The task. It receives the index in [0, n).
+     */
+    void parallel_for(unsigned int n, std::function<void(unsigned int)> const & f) {
+        if (workers.size() == 0) {
+            for (unsigned int i = 0; i < n; ++i) {
+                f(i);
+            }
+            return;
+        }
+
+        std::atomic<unsigned int> cur(0);
+        run([&](unsigned int) {
+            for (unsigned int i = cur++; i < n; i = cur++) {
+                f(i);
+            }
+        });
+    }
+
+    /**
+     * @brief  Stops and joins all threads.
+     */
+    ~ThreadPool() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start.notify_all();
+        for (auto &w : workers) {
+            w.join();
+        }
+    }
+};
+
+#endif // THREADPOOL_H
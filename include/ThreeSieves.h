@@ -8,6 +8,8 @@
 #include <random>
 #include <unordered_set>
 #include <string>
+#include <limits>
+#include <cmath>
 
 /**
  * @brief  The ThreeSieves algorithm for submodular function maximization. This optimizer tries to estimate the probability that a given item is not `out-valued' in the future. To do so, it compares the marginal gain of each item against a pre-computed threshold. If this threshold is too large and the algorithm therefore rejects most items, it reduces the threshold after \f$ T \f$ tries. The confidence interval of not finding an element in the stream which would out-value the current threshold is given by the Rule Of Three, hence the name:
@@ -55,6 +57,127 @@
  * 
  */
 class ThreeSieves : public SubmodularOptimizer {
+protected:
+    // Scratch space for next_block: The candidates of the current window which may exceed their thresholds, their thresholds and their function values
+    std::vector<unsigned int> candidates;
+    std::vector<data_t> taus;
+    std::vector<data_t> fvals;
+
+    // Upper bounds on the gains of the objects of the current block in next_block. These are the gains w.r.t. an earlier (smaller) solution, which can only decrease for submodular functions
+    std::vector<data_t> bounds;
+
+    // The number of objects which next_block evaluates at once. It grows while objects are rejected and shrinks after an acceptance
+    unsigned int window = 1;
+
+    // The minimum number of candidates for which next_block uses peek_batch. Fewer candidates are peeked one at a time, so that nothing is evaluated past an acceptance
+    static constexpr unsigned int min_batch_size = 32;
+
+    /**
+     * @brief  Returns the threshold which follows the given one after T unsuccessful tries according to the threshold strategy.
+     * @param  threshold: The current threshold.
+     */
+    data_t reduce(data_t threshold) const {
+        switch(strategy) {
+            case THRESHOLD_STRATEGY::SIEVE: 
+            {
+                data_t tmp = std::log(threshold) / std::log(1.0 + epsilon);
+                int i;
+                if (tmp == std::floor(tmp) || std::abs(tmp - std::floor(tmp)) < 1e-7) {
+                    i = std::floor(tmp) - 1;
+                } else {
+                    i = std::floor(tmp);
+                }
+                return std::pow(1+epsilon, i);
+            }
+            case THRESHOLD_STRATEGY::CONSTANT:
+            default:
+            {
+                return threshold - (threshold - epsilon);
+            }
+        }
+    }
+
+    /**
+     * @brief  Consume the objects X[begin], ..., X[end - 1] with the same result as calling `next` for each of them. The solution only changes if an object is accepted, which is rare once the solution holds a few objects. Thus we assume that all objects of the next window are rejected, compute the threshold each object would be compared against and evaluate all objects which pass the upper bound with a single call to `peek_batch` against the current solution. The first object whose gain exceeds its threshold is accepted and the counter and the threshold are advanced to it. The gains of the remaining objects are not wasted, since they bound their gains w.r.t. the new solution for submodular functions (similar to LazyGreedy). Thus only the few objects whose bound still exceeds the threshold are evaluated again.
+     * @param  X: A constant reference to the data.
+     * @param  ids: The ids of the objects. The id ids[j] is used for X[j] if j < ids.size().
+     * @param  begin: The first object of the block.
+     * @param  end: One past the last object of the block.
+     */
+    void next_block(std::vector<std::vector<data_t>> const & X, std::vector<idx_t> const & ids, unsigned int begin, unsigned int end) override {
+        // peek_batch may round differently than peek. Hence, the bounds are slightly relaxed and the final decision is always made with peek as in next
+        data_t const slack = std::sqrt(std::numeric_limits<data_t>::epsilon());
+        bounds.assign(end - begin, std::numeric_limits<data_t>::max());
+
+        unsigned int j = begin;
+        while (j < end && solution.size() < K) {
+            unsigned int Kcur = solution.size();
+            unsigned int stop = std::min(end, j + window);
+
+            candidates.clear();
+            taus.clear();
+            data_t th = threshold;
+            unsigned int tries = t;
+            for (unsigned int i = j; i < stop; ++i) {
+                if (tries >= T) {
+                    th = reduce(th);
+                    tries = 0;
+                }
+                ++tries;
+
+                data_t tau = (th / 2.0 - fval) / static_cast<data_t>(K - Kcur);
+                if (bounds[i - begin] >= tau && f->gain_upper_bound(solution, X[i]) >= tau) {
+                    candidates.push_back(i);
+                    taus.push_back(tau);
+                }
+            }
+
+            if (candidates.size() >= min_batch_size) {
+                f->peek_batch(solution, X, candidates, fvals);
+                for (unsigned int c = 0; c < candidates.size(); ++c) {
+                    bounds[candidates[c] - begin] = fvals[c] - fval + slack * (1.0 + std::abs(fvals[c]));
+                }
+            }
+
+            unsigned int accepted = stop;
+            data_t fdelta = 0;
+            for (unsigned int c = 0; c < candidates.size(); ++c) {
+                if (bounds[candidates[c] - begin] >= taus[c]) {
+                    fdelta = f->peek(solution, X[candidates[c]], solution.size()) - fval;
+                    bounds[candidates[c] - begin] = fdelta + slack * (1.0 + std::abs(fdelta + fval));
+                    if (fdelta >= taus[c]) {
+                        accepted = candidates[c];
+                        break;
+                    }
+                }
+            }
+
+            // All objects before the accepted one are rejected
+            for (; j < accepted; ++j) {
+                if (t >= T) {
+                    threshold = reduce(threshold);
+                    t = 0;
+                }
+                ++t;
+            }
+
+            if (accepted < stop) {
+                window = std::max(1u, window / 2);
+                if (t >= T) {
+                    threshold = reduce(threshold);
+                }
+                f->update(solution, X[accepted], solution.size());
+                solution.push_back(X[accepted]);
+                if (accepted < ids.size()) this->ids.push_back(ids[accepted]);
+                fval += fdelta;
+                t = 0;
+                j = accepted + 1;
+            } else {
+                window = std::min(block_size, 2 * window);
+            }
+        }
+        is_fitted = true;
+    }
 
 public:
     /**
@@ -160,32 +283,21 @@ public:
         unsigned int Kcur = solution.size();
         if (Kcur < K) {
             if (t >= T) {
-                switch(strategy) {
-                    case THRESHOLD_STRATEGY::SIEVE: 
-                    {
-                        data_t tmp = std::log(threshold) / std::log(1.0 + epsilon);
-                        int i;
-                        if (tmp == std::floor(tmp) || std::abs(tmp - std::floor(tmp)) < 1e-7) {
-                            i = std::floor(tmp) - 1;
-                        } else {
-                            i = std::floor(tmp);
-                        }
-                        threshold = std::pow(1+epsilon, i);
-                        break;
-                    }
-                    case THRESHOLD_STRATEGY::CONSTANT:
-                    {
-                        threshold -= threshold - epsilon;
-                        break;
-                    }
-                }
+                threshold = reduce(threshold);
                 t = 0;
             }
 
-            data_t fdelta = f->peek(solution, x, solution.size()) - fval;
             data_t tau = (threshold / 2.0 - fval) / static_cast<data_t>(K - Kcur);
+
+            // Only peek if the element can exceed the threshold at all 
+            data_t fdelta = 0;
+            bool accept = false;
+            if (f->gain_upper_bound(solution, x) >= tau) {
+                fdelta = f->peek(solution, x, solution.size()) - fval;
+                accept = fdelta >= tau;
+            }
             
-            if (fdelta >= tau) {
+            if (accept) {
                 f->update(solution, x, solution.size());
                 solution.push_back(x);
                 if (id.has_value()) ids.push_back(id.value());
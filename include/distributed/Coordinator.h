@@ -0,0 +1,165 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include <vector>
+#include <map>
+#include <numeric>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+
+#include "DataTypeHandling.h"
+#include "SubmodularFunction.h"
+#include "LazyGreedy.h"
+#include "distributed/Snapshot.h"
+#include "distributed/Transport.h"
+
+/**
+ * @brief  Collects the snapshots of several StreamWorkers and merges them into a global summary. The coordinator keeps the latest snapshot of each worker. On `merge` it runs (Lazy)Greedy on the union of the latest solutions and keeps the best among this merged solution and the solutions of the individual workers, similar to the second round of GreeDi (see PartitionedGreedy).
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(dim), 1.0) , 1.0);
+ *  UnixSocketReceiver receiver("/tmp/ssm.sock", num_workers);
+ *  Coordinator coordinator(K, fastIVM);
+ *  coordinator.run(receiver);
+ *  coordinator.merge();
+ *  auto summary = coordinator.get_solution();
+ * @endcode
+ *
+ * __References__
+ *
+ * - Mirzasoleiman, B., Karbasi, A., Sarkar, R., & Krause, A. (2013). Distributed Submodular Maximization: Identifying Representative Elements in Massive Data. In Advances in Neural Information Processing Systems 26 (pp. 2049–2057).
+ */
+class Coordinator {
+private:
+    unsigned int K;
+    std::shared_ptr<SubmodularFunction> f;
+
+    // The latest snapshot of each worker
+    std::map<unsigned int, Snapshot> snapshots;
+
+    // The merged solution
+    std::vector<std::vector<data_t>> solution;
+    std::vector<idx_t> ids;
+    data_t fval;
+
+public:
+    /**
+     * @brief  Creates a new coordinator.
+     * @param  K: The cardinality constraint of the global summary.
+     * @param  f: The function which should be maximized. Note, that the `clone' function is used to construct a new SubmodularFunction which is owned by this object.
+     */
+    Coordinator(unsigned int K, SubmodularFunction & f) : K(K), f(f.clone()), fval(0) {}
+
+    /**
+     * @brief  Creates a new coordinator.
+     * @param  K: The cardinality constraint of the global summary.
+     * @param  f: The function which should be maximized. Note, that this parameter is likely moved and not copied.
+     */
+    Coordinator(unsigned int K, std::function<data_t (std::vector<std::vector<data_t>> const &)> f) : K(K), f(std::make_shared<SubmodularFunctionWrapper>(f)), fval(0) {}
+
+    /**
+     * @brief  Stores the given snapshot, if it is newer than the last snapshot of the same worker.
+     * @param  &s: The snapshot.
+     */
+    void add(Snapshot s) {
+        auto it = snapshots.find(s.worker);
+        if (it == snapshots.end()) {
+            snapshots.emplace(s.worker, std::move(s));
+        } else if (s.sequence > it->second.sequence) {
+            it->second = std::move(s);
+        }
+    }
+
+    /**
+     * @brief  Receives and stores snapshots until all workers are finished.
+     * @param  &receiver: The transport from the workers.
+     */
+    void run(Receiver & receiver) {
+        while (auto message = receiver.receive()) {
+            add(deserialize(message.value()));
+        }
+    }
+
+    /**
+     * @brief  Merges the latest snapshots of all workers into a global summary. This can be called at any time, e.g. periodically while the workers are still running. You can access the solution via `get_solution` and the corresponding ids (if all workers sent ids) with `get_ids()`.
+     */
+    void merge() {
+        std::vector<std::vector<data_t>> X;
+        std::vector<idx_t> X_ids;
+        bool has_ids = true;
+        Snapshot const * best = nullptr;
+        for (auto const & [worker, s] : snapshots) {
+            X.insert(X.end(), s.solution.begin(), s.solution.end());
+            X_ids.insert(X_ids.end(), s.ids.begin(), s.ids.end());
+            has_ids = has_ids && s.ids.size() == s.solution.size();
+            if (best == nullptr || s.fval > best->fval) {
+                best = &s;
+            }
+        }
+
+        std::vector<unsigned int> all(X.size());
+        std::iota(all.begin(), all.end(), 0);
+        LazyGreedy greedy(K, *f);
+        auto selected = greedy.select(X, all);
+
+        solution.clear();
+        ids.clear();
+        if (best != nullptr && best->fval > greedy.get_fval()) {
+            solution = best->solution;
+            ids = has_ids ? best->ids : std::vector<idx_t>();
+            fval = best->fval;
+        } else {
+            solution = greedy.get_solution();
+            if (has_ids) {
+                for (auto idx : selected) {
+                    ids.push_back(X_ids[idx]);
+                }
+            }
+            fval = greedy.get_fval();
+        }
+    }
+
+    /**
+     * @brief  Returns true if all workers which sent a snapshot so far also sent their final snapshot.
+     */
+    bool all_final() const {
+        for (auto const & [worker, s] : snapshots) {
+            if (!s.final) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief  Returns the number of workers which sent at-least one snapshot.
+     */
+    unsigned long get_num_workers() const {
+        return snapshots.size();
+    }
+
+    /**
+     * @brief  Returns the merged solution. Call `merge` first.
+     */
+    std::vector<std::vector<data_t>> const & get_solution() const {
+        return solution;
+    }
+
+    /**
+     * @brief  Returns the ids of the merged solution. This is empty if any worker did not send ids.
+     */
+    std::vector<idx_t> const & get_ids() const {
+        return ids;
+    }
+
+    /**
+     * @brief  Returns the function value of the merged solution.
+     */
+    data_t get_fval() const {
+        return fval;
+    }
+};
+
+#endif // COORDINATOR_H
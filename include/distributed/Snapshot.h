@@ -0,0 +1,117 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#include "DataTypeHandling.h"
+
+/**
+ * @brief  A compact copy of the current solution of a worker which is shipped to the Coordinator. Snapshots are (de-)serialized into a flat byte buffer so that they can be sent over any Transport. The buffer uses the native byte order and data_t / idx_t of the sender. Thus, all workers and the coordinator should be compiled for the same platform.
+ */
+struct Snapshot {
+    // The worker which sent this snapshot
+    uint32_t worker = 0;
+
+    // Increased by the worker for every snapshot, so that the coordinator can ignore outdated snapshots
+    uint64_t sequence = 0;
+
+    // True if this is the last snapshot of the worker, i.e. the worker has consumed its entire partition
+    bool final = false;
+
+    // The solution of the worker, its ids (if any) and its function value
+    data_t fval = 0;
+    std::vector<std::vector<data_t>> solution;
+    std::vector<idx_t> ids;
+};
+
+namespace snapshot_detail {
+    template <typename T>
+    void write(std::vector<char> & buffer, T const & value) {
+        char const * p = reinterpret_cast<char const *>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    T read(std::vector<char> const & buffer, size_t & pos) {
+        if (pos + sizeof(T) > buffer.size()) {
+            throw std::runtime_error("Snapshot: The message is truncated.");
+        }
+        T value;
+        std::memcpy(&value, buffer.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+}
+
+/**
+ * @brief  Serializes a snapshot into a flat byte buffer.
+ * @param  &s: The snapshot.
+ * @retval The serialized snapshot.
+ */
+inline std::vector<char> serialize(Snapshot const & s) {
+    using namespace snapshot_detail;
+
+    uint64_t dim = s.solution.size() > 0 ? s.solution[0].size() : 0;
+    std::vector<char> buffer;
+    buffer.reserve(48 + s.solution.size() * dim * sizeof(data_t) + s.ids.size() * sizeof(idx_t));
+
+    write(buffer, s.worker);
+    write(buffer, s.sequence);
+    write(buffer, static_cast<uint8_t>(s.final));
+    write(buffer, s.fval);
+    write(buffer, static_cast<uint64_t>(s.solution.size()));
+    write(buffer, dim);
+    for (auto const & x : s.solution) {
+        if (x.size() != dim) {
+            throw std::runtime_error("Snapshot: All elements in the solution must have the same dimension.");
+        }
+        char const * p = reinterpret_cast<char const *>(x.data());
+        buffer.insert(buffer.end(), p, p + dim * sizeof(data_t));
+    }
+    write(buffer, static_cast<uint64_t>(s.ids.size()));
+    char const * p = reinterpret_cast<char const *>(s.ids.data());
+    buffer.insert(buffer.end(), p, p + s.ids.size() * sizeof(idx_t));
+
+    return buffer;
+}
+
+/**
+ * @brief  Deserializes a snapshot from a byte buffer created by `serialize`. Throws a std::runtime_error if the buffer is malformed.
+ * @param  &buffer: The serialized snapshot.
+ * @retval The snapshot.
+ */
+inline Snapshot deserialize(std::vector<char> const & buffer) {
+    using namespace snapshot_detail;
+
+    size_t pos = 0;
+    Snapshot s;
+    s.worker = read<uint32_t>(buffer, pos);
+    s.sequence = read<uint64_t>(buffer, pos);
+    s.final = read<uint8_t>(buffer, pos) != 0;
+    s.fval = read<data_t>(buffer, pos);
+    uint64_t n = read<uint64_t>(buffer, pos);
+    uint64_t dim = read<uint64_t>(buffer, pos);
+    if (dim > 0 && n > (buffer.size() - pos) / (dim * sizeof(data_t))) {
+        throw std::runtime_error("Snapshot: The message is truncated.");
+    }
+
+    s.solution.resize(n, std::vector<data_t>(dim));
+    for (auto & x : s.solution) {
+        std::memcpy(x.data(), buffer.data() + pos, dim * sizeof(data_t));
+        pos += dim * sizeof(data_t);
+    }
+
+    uint64_t num_ids = read<uint64_t>(buffer, pos);
+    if (num_ids > (buffer.size() - pos) / sizeof(idx_t)) {
+        throw std::runtime_error("Snapshot: The message is truncated.");
+    }
+    s.ids.resize(num_ids);
+    std::memcpy(s.ids.data(), buffer.data() + pos, num_ids * sizeof(idx_t));
+
+    return s;
+}
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,96 @@
+#ifndef STREAMWORKER_H
+#define STREAMWORKER_H
+
+#include <vector>
+#include <optional>
+#include <limits>
+
+#include "DataTypeHandling.h"
+#include "SubmodularOptimizer.h"
+#include "distributed/Snapshot.h"
+#include "distributed/Transport.h"
+
+/**
+ * @brief  Runs a streaming optimizer (e.g. ThreeSieves or SieveStreaming) on the partition of a stream which arrives at one worker and periodically ships snapshots of its solution to a Coordinator. A snapshot is only sent if the function value improved since the last snapshot, so that the traffic is at most \f$ O(K \cdot d) \f$ per interval.
+ *
+ * Example usage in C++:
+ * @code{.cpp}
+ *  FastIVM fastIVM(K, RBFKernel( std::sqrt(dim), 1.0) , 1.0);
+ *  ThreeSieves opt(K, fastIVM, 1.0, 0.01, "sieve", 50);
+ *  UnixSocketSender sender("/tmp/ssm.sock");
+ *  StreamWorker worker(opt, sender, worker_id, 1000);
+ *  while (has_next()) {
+ *      worker.next(read_next());
+ *  }
+ *  worker.finish();
+ * @endcode
+ */
+class StreamWorker {
+private:
+    SubmodularOptimizer & opt;
+    Sender & sender;
+
+    unsigned int worker;
+
+    // A snapshot is considered every interval elements
+    unsigned long interval;
+
+    // The number of elements consumed so far, the number of snapshots sent so far and the function value of the last snapshot
+    unsigned long n;
+    unsigned long sequence;
+    data_t last_fval;
+
+    void send(bool final) {
+        Snapshot s;
+        s.worker = worker;
+        s.sequence = sequence++;
+        s.final = final;
+        if (n > 0) {
+            s.fval = opt.get_fval();
+            s.solution = opt.get_solution();
+            s.ids = opt.get_ids();
+        }
+        sender.send(serialize(s));
+        last_fval = s.fval;
+    }
+
+public:
+    /**
+     * @brief  Creates a new worker.
+     * @param  &opt: The streaming optimizer. The worker does not take ownership, so opt must outlive the worker.
+     * @param  &sender: The transport to the coordinator. The worker does not take ownership, so sender must outlive the worker.
+     * @param  worker: The unique id of this worker.
+     * @param  interval: The number of elements between two (potential) snapshots.
+     */
+    StreamWorker(SubmodularOptimizer & opt, Sender & sender, unsigned int worker, unsigned long interval)
+        : opt(opt), sender(sender), worker(worker), interval(interval), n(0), sequence(0), last_fval(std::numeric_limits<data_t>::lowest()) {}
+
+    /**
+     * @brief  Consumes the next element of this worker's partition and sends a snapshot every interval elements if the solution improved.
+     * @param  &x: A constant reference to the next object on the stream.
+     * @param  id: The id of the given object.
+     */
+    void next(std::vector<data_t> const &x, std::optional<idx_t> const id = std::nullopt) {
+        opt.next(x, id);
+        ++n;
+        if (interval > 0 && n % interval == 0 && opt.get_fval() > last_fval) {
+            send(false);
+        }
+    }
+
+    /**
+     * @brief  Sends the final snapshot. Call this once the partition has been consumed entirely.
+     */
+    void finish() {
+        send(true);
+    }
+
+    /**
+     * @brief  Returns the number of snapshots sent so far.
+     */
+    unsigned long get_num_snapshots() const {
+        return sequence;
+    }
+};
+
+#endif // STREAMWORKER_H
@@ -0,0 +1,35 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <vector>
+#include <optional>
+
+/**
+ * @brief  The sending end of a transport. Workers use it to ship serialized snapshots to the coordinator. Implement this (and Receiver) to use a different transport, e.g. TCP or a message queue.
+ */
+class Sender {
+public:
+    /**
+     * @brief  Sends a message. Messages of the same sender arrive in the order they were sent. Throws a std::runtime_error if the message could not be sent.
+     * @param  &message: The message.
+     */
+    virtual void send(std::vector<char> const & message) = 0;
+
+    virtual ~Sender() {}
+};
+
+/**
+ * @brief  The receiving end of a transport. The coordinator uses it to collect the messages of all workers.
+ */
+class Receiver {
+public:
+    /**
+     * @brief  Blocks until the next message of any sender is available.
+     * @retval The message or std::nullopt if all senders are finished and no messages are left.
+     */
+    virtual std::optional<std::vector<char>> receive() = 0;
+
+    virtual ~Receiver() {}
+};
+
+#endif // TRANSPORT_H
@@ -0,0 +1,228 @@
+#ifndef UNIXSOCKETTRANSPORT_H
+#define UNIXSOCKETTRANSPORT_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "distributed/Transport.h"
+
+namespace unix_socket_detail {
+    inline std::runtime_error error(std::string const & what) {
+        return std::runtime_error("UnixSocketTransport: " + what + ": " + std::strerror(errno));
+    }
+
+    inline sockaddr_un address(std::string const & path) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("UnixSocketTransport: The socket path " + path + " is too long.");
+        }
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        return addr;
+    }
+
+    /**
+     * @brief  Reads exactly size bytes from fd.
+     * @retval False if the connection was closed before the first byte was read. Throws a std::runtime_error if it was closed in-between.
+     */
+    inline bool read_all(int fd, char * data, size_t size) {
+        size_t pos = 0;
+        while (pos < size) {
+            ssize_t n = ::read(fd, data + pos, size - pos);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw error("read failed");
+            }
+            if (n == 0) {
+                if (pos == 0) return false;
+                throw std::runtime_error("UnixSocketTransport: The connection was closed in the middle of a message.");
+            }
+            pos += n;
+        }
+        return true;
+    }
+
+    inline void write_all(int fd, char const * data, size_t size) {
+        size_t pos = 0;
+        while (pos < size) {
+            // MSG_NOSIGNAL so that a crashed coordinator results in an exception instead of SIGPIPE
+            ssize_t n = ::send(fd, data + pos, size - pos, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw error("send failed");
+            }
+            pos += n;
+        }
+    }
+}
+
+/**
+ * @brief  Sends messages to a UnixSocketReceiver over a Unix domain stream socket. Each message is prefixed with its length.
+ */
+class UnixSocketSender : public Sender {
+private:
+    int fd;
+
+public:
+    /**
+     * @brief  Connects to the UnixSocketReceiver listening on the given path.
+     * @param  &path: The path of the socket.
+     * @param  timeout_ms: The receiver may not be listening yet if workers and coordinator are started at the same time. Thus, connecting is retried for up to timeout_ms milliseconds.
+     */
+    UnixSocketSender(std::string const & path, unsigned int timeout_ms = 5000) {
+        sockaddr_un addr = unix_socket_detail::address(path);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+        while (true) {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) {
+                throw unix_socket_detail::error("socket failed");
+            }
+            if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+                break;
+            }
+            int e = errno;
+            ::close(fd);
+            errno = e;
+            if ((e != ENOENT && e != ECONNREFUSED) || std::chrono::steady_clock::now() >= deadline) {
+                throw unix_socket_detail::error("connect to " + path + " failed");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    UnixSocketSender(UnixSocketSender const &) = delete;
+    UnixSocketSender & operator=(UnixSocketSender const &) = delete;
+
+    void send(std::vector<char> const & message) {
+        uint64_t size = message.size();
+        unix_socket_detail::write_all(fd, reinterpret_cast<char const *>(&size), sizeof(size));
+        unix_socket_detail::write_all(fd, message.data(), message.size());
+    }
+
+    /**
+     * @brief  Closes the connection. The receiver treats this sender as finished.
+     */
+    ~UnixSocketSender() {
+        ::close(fd);
+    }
+};
+
+/**
+ * @brief  Receives the messages of a fixed number of UnixSocketSenders over a Unix domain stream socket. This lets workers and coordinator run in different processes on the same machine, e.g. to test a distributed setup on a single box.
+ */
+class UnixSocketReceiver : public Receiver {
+private:
+    std::string path;
+    int listen_fd;
+
+    // The number of senders which are expected to connect and the number of senders which did connect so far
+    unsigned int num_senders;
+    unsigned int num_accepted;
+
+    // The connections of all senders which are not finished yet
+    std::vector<int> clients;
+
+public:
+    /**
+     * @brief  Creates the socket and starts listening. An existing file at path is removed.
+     * @param  &path: The path of the socket.
+     * @param  num_senders: The number of senders. `receive` returns std::nullopt after this many senders connected and closed their connection.
+     */
+    UnixSocketReceiver(std::string const & path, unsigned int num_senders) : path(path), num_senders(num_senders), num_accepted(0) {
+        sockaddr_un addr = unix_socket_detail::address(path);
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0) {
+            throw unix_socket_detail::error("socket failed");
+        }
+
+        ::unlink(path.c_str());
+        if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd, num_senders) != 0) {
+            int e = errno;
+            ::close(listen_fd);
+            errno = e;
+            throw unix_socket_detail::error("listening on " + path + " failed");
+        }
+    }
+
+    UnixSocketReceiver(UnixSocketReceiver const &) = delete;
+    UnixSocketReceiver & operator=(UnixSocketReceiver const &) = delete;
+
+    std::optional<std::vector<char>> receive() {
+        std::vector<pollfd> fds;
+        while (num_accepted < num_senders || clients.size() > 0) {
+            fds.clear();
+            unsigned int num_polled = clients.size();
+            for (int c : clients) {
+                fds.push_back({c, POLLIN, 0});
+            }
+            if (num_accepted < num_senders) {
+                fds.push_back({listen_fd, POLLIN, 0});
+            }
+
+            if (::poll(fds.data(), fds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                throw unix_socket_detail::error("poll failed");
+            }
+
+            if (num_accepted < num_senders && fds.back().revents != 0) {
+                int c = ::accept(listen_fd, nullptr, nullptr);
+                if (c < 0) {
+                    if (errno == EINTR) continue;
+                    throw unix_socket_detail::error("accept failed");
+                }
+                clients.push_back(c);
+                ++num_accepted;
+            }
+
+            // Senders write messages as a whole, hence we read the entire message once its first byte is available
+            for (unsigned int i = 0; i < num_polled; ++i) {
+                if (fds[i].revents == 0) {
+                    continue;
+                }
+
+                uint64_t size;
+                if (!unix_socket_detail::read_all(fds[i].fd, reinterpret_cast<char *>(&size), sizeof(size))) {
+                    ::close(fds[i].fd);
+                    clients.erase(std::find(clients.begin(), clients.end(), fds[i].fd));
+                    break;
+                }
+
+                std::vector<char> message(size);
+                if (size > 0 && !unix_socket_detail::read_all(fds[i].fd, message.data(), size)) {
+                    throw std::runtime_error("UnixSocketTransport: The connection was closed in the middle of a message.");
+                }
+                return message;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * @brief  Closes all connections and removes the socket file.
+     */
+    ~UnixSocketReceiver() {
+        for (int c : clients) {
+            ::close(c);
+        }
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+    }
+};
+
+#endif // UNIXSOCKETTRANSPORT_H
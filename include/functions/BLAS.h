@@ -0,0 +1,103 @@
+#ifndef SSM_BLAS_H
+#define SSM_BLAS_H
+
+/*
+ * Thin wrappers around the few BLAS / LAPACK routines we use if the project is compiled with SSM_USE_BLAS (see the
+ * SSM_USE_BLAS option in CMakeLists.txt). This allows us to use a vendor-tuned (and possibly multi-threaded) BLAS such
+ * as OpenBLAS or BLIS for the heavy lifting. Without SSM_USE_BLAS this header is empty and the header-only
+ * implementations in Matrix.h etc. are used. All wrappers expect row-major data and dispatch to the single / double
+ * precision routine via overloading, depending on data_t.
+ */
+#ifdef SSM_USE_BLAS
+
+#include <cblas.h>
+
+#include "DataTypeHandling.h"
+
+// LAPACK does not ship a C++ header and LAPACKE is not always installed. Thus we declare the fortran routines we need.
+extern "C" {
+    void dpotrf_(char const * uplo, int const * n, double * a, int const * lda, int * info);
+    void spotrf_(char const * uplo, int const * n, float * a, int const * lda, int * info);
+    void dpptrf_(char const * uplo, int const * n, double * ap, int * info);
+    void spptrf_(char const * uplo, int const * n, float * ap, int * info);
+}
+
+/**
+ * @brief  Computes the cholesky decomposition of the row-major n x n matrix A (with leading dimension lda) in-place. Afterwards, the lower triangle holds L with LL^T = A. A row-major lower triangle is a column-major upper triangle, hence we call LAPACK with uplo = 'U'.
+ * @param  A: The matrix which should be decomposed
+ * @param  n: The number of rows / columns
+ * @param  lda: The leading dimension (row stride) of A
+ * @retval 0 on success. If i > 0, then the leading minor of order i is not positive definite.
+ */
+inline int blas_potrf(double * A, int n, int lda) {
+    char uplo = 'U';
+    int info = 0;
+    dpotrf_(&uplo, &n, A, &lda, &info);
+    return info;
+}
+
+inline int blas_potrf(float * A, int n, int lda) {
+    char uplo = 'U';
+    int info = 0;
+    spotrf_(&uplo, &n, A, &lda, &info);
+    return info;
+}
+
+/**
+ * @brief  Computes the cholesky decomposition of the n x n matrix stored as packed row-major lower triangle in-place. A packed row-major lower triangle has the same layout as a packed column-major upper triangle, hence we call LAPACK with uplo = 'U'.
+ * @param  A: The packed matrix which should be decomposed
+ * @param  n: The number of rows / columns
+ * @retval 0 on success. If i > 0, then the leading minor of order i is not positive definite.
+ */
+inline int blas_pptrf(double * A, int n) {
+    char uplo = 'U';
+    int info = 0;
+    dpptrf_(&uplo, &n, A, &info);
+    return info;
+}
+
+inline int blas_pptrf(float * A, int n) {
+    char uplo = 'U';
+    int info = 0;
+    spptrf_(&uplo, &n, A, &info);
+    return info;
+}
+
+/**
+ * @brief  Solves LX = B for X in-place where L is a row-major n x n lower triangular matrix and B is a row-major n x m matrix (triangular solve with multiple right-hand sides).
+ * @param  L: The lower triangular matrix
+ * @param  ldl: The leading dimension (row stride) of L
+ * @param  B: The right-hand sides. Overwritten with the solution X.
+ * @param  ldb: The leading dimension (row stride) of B
+ * @param  n: The number of rows / columns of L
+ * @param  m: The number of right-hand sides
+ */
+inline void blas_trsm_lower(double const * L, int ldl, double * B, int ldb, int n, int m) {
+    cblas_dtrsm(CblasRowMajor, CblasLeft, CblasLower, CblasNoTrans, CblasNonUnit, n, m, 1.0, L, ldl, B, ldb);
+}
+
+inline void blas_trsm_lower(float const * L, int ldl, float * B, int ldb, int n, int m) {
+    cblas_strsm(CblasRowMajor, CblasLeft, CblasLower, CblasNoTrans, CblasNonUnit, n, m, 1.0f, L, ldl, B, ldb);
+}
+
+/**
+ * @brief  Computes C = A B^T where A is a row-major n x d matrix, B is a row-major m x d matrix and C is a row-major n x m matrix with leading dimension ldc.
+ * @param  A: The first matrix
+ * @param  B: The second matrix
+ * @param  C: The result
+ * @param  n: The number of rows of A
+ * @param  m: The number of rows of B
+ * @param  d: The number of columns of A and B
+ * @param  ldc: The leading dimension (row stride) of C
+ */
+inline void blas_gemm_nt(double const * A, double const * B, double * C, int n, int m, int d, int ldc) {
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, n, m, d, 1.0, A, d, B, d, 0.0, C, ldc);
+}
+
+inline void blas_gemm_nt(float const * A, float const * B, float * C, int n, int m, int d, int ldc) {
+    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, n, m, d, 1.0f, A, d, B, d, 0.0f, C, ldc);
+}
+
+#endif // SSM_USE_BLAS
+
+#endif // SSM_BLAS_H
@@ -7,6 +7,7 @@
 #include <math.h>
 #include <cassert>
 #include <numeric>
+#include <algorithm>
 
 #include "DataTypeHandling.h"
 #include "SubmodularFunction.h"
@@ -19,7 +20,7 @@
  * \f]
  *  where \f$\Sigma\f$ is the kernel matrix of all elements in the summary, \f$ \mathcal I \f$ is the \f$ K \times K \f$ identity matrix and \f$ \sigma > 0 \f$ is a scaling parameter. 
  * 
- * This implementation caches the current kernel matrix \f$ \Sigma \f$ and maintains a cholesky decomposition of it to quickly recompute the log-determinant. This implementation requires the maximum number items in the summary and the maximum size (rows and columns) of \Sigma beforehand. It allocates the appropriate memory during construction. This implementation is optimized towards adding new elements to the summary, but not replacing existing ones. Added a new row / column to a cholesky decomposition is a rank-1 update which can be performed in \f$ O(K^2) \f$ for \f$ K \times K \f$ matrices. Whenever an element in the matrix must be replaced, the entire cholesky decomposition must be recomputed leading to \f$ O(K^3) \f$. This class internally uses the Matrix class for somewhat readable linear algebra. 
+ * This implementation maintains a cholesky decomposition of the current kernel matrix \f$ \Sigma \f$ to quickly recompute the log-determinant. The cholesky decomposition is stored as a packed LowerTriangularMatrix, so that only \f$ (K+1)(K+2)/2 \f$ entries are required. This implementation requires the maximum number items in the summary and the maximum size (rows and columns) of \Sigma beforehand. It allocates the appropriate memory during construction. Added a new row / column to a cholesky decomposition is a rank-1 update which can be performed in \f$ O(K^2) \f$ for \f$ K \times K \f$ matrices. Replacing an element in the summary changes one row / column of the kernel matrix, which is performed as a rank-1 update followed by a rank-1 downdate of the cholesky decomposition, again in \f$ O(K^2) \f$. This class internally uses the LowerTriangularMatrix class for somewhat readable linear algebra. 
  * 
  * __References__
  * 
@@ -29,18 +30,117 @@ class FastIVM : public IVM {
 private:
     
 protected:
-    // Number of items added so far. Required to maintain consistent access to kmat and L
+    // Number of items added so far. Required to maintain consistent access to L
     unsigned int added;
 
-    // The kernel matrix \Sigma. 
-    Matrix kmat;
-
-    // The lower triangle matrix of the cholesky decomposition. Note that it stores K x K elements, even though only 1/2 * K * K + K are required for a lower triangle matrix 
-    Matrix L;
+    // The lower triangle matrix of the cholesky decomposition of the kernel matrix \Sigma in packed storage. The kernel matrix itself is not stored, since the few entries which are required when replacing an element can be recovered from L.
+    LowerTriangularMatrix L;
 
     // The current function value
     data_t fval;
 
+    // The diagonal entries \Sigma_{ii} + \sigma of the kernel matrix. These are used for the gain_upper_bound.
+    std::vector<data_t> diag;
+
+    // Scratch space for replacing elements: The cholesky decomposition after the replacement, the new row of the kernel matrix and the vectors of the rank-one update / downdate. This is only allocated during the first replacement, since most optimizers never replace elements.
+    LowerTriangularMatrix L_replace;
+    std::vector<data_t> krow, u, w;
+
+    // The element and the position of the last call to `peek`. We often have the peek() -> update() pattern with the same element. In this case, update re-uses the kernel row and the cholesky decomposition computed during peek.
+    std::vector<data_t> last_x;
+    unsigned int last_pos;
+    bool last_valid;
+
+    // Scratch space for peek_batch. Holds the kernel block between the current summary and a block of candidates which is overwritten by the solution of the triangular system.
+    std::vector<data_t> batch;
+
+    // Scratch space for peek_batch. Pointers to the elements of the current summary and to the current block of candidates for Kernel::block.
+    std::vector<std::vector<data_t> const *> batch_rows, batch_cols;
+
+#ifndef SSM_USE_BLAS
+    // Scratch space for peek_batch. The solutions of the triangular systems with one contiguous row per candidate.
+    std::vector<data_t> batch_t;
+#endif
+
+#ifdef SSM_USE_BLAS
+    // Scratch space for peek_batch. The cholesky decomposition in regular (unpacked) storage as expected by BLAS.
+    std::vector<data_t> L_unpacked;
+#endif
+
+    // The number of candidates which are processed together in peek_batch. This bounds the size of the scratch space to K x batch_size
+    static constexpr unsigned int batch_size = 128;
+
+    /**
+     * @brief  Checks if the last call to `peek` used the same element at the same position, so that its results can be committed directly.
+     * @param  &x: The element which should be added to the summary
+     * @param  pos: The position at which the given element should be inserted.
+     * @retval True if the results of the last peek can be re-used, false otherwise.
+     */
+    inline bool is_last_peek(std::vector<data_t> const &x, unsigned int pos) const {
+        return last_valid && last_pos == std::min(pos, added) && last_x == x;
+    }
+
+    /**
+     * @brief  Computes the new row of the cholesky decomposition in-place via forward substitution, given that L.row(added) holds the kernel values of the new element.
+     * @retval The log-determinant of the kernel matrix with the new element appended.
+     */
+    inline data_t solve_row() {
+        data_t * const row = L.row(added);
+        for (unsigned int j = 0; j < added; ++j) {
+            row[j] = (row[j] - dot(row, L.row(j), j)) / L(j, j);
+        }
+        row[added] = std::sqrt(row[added] - dot(row, row, added));
+
+        return fval + 2.0 * std::log(row[added]);
+    }
+
+    /**
+     * @brief  Computes the cholesky decomposition of the kernel matrix in which the element at position pos is replaced by x and stores it in L_replace. The new row / column of the kernel matrix is stored in krow. 
+     * Replacing an element changes row and column pos of the kernel matrix by some vector d, i.e. \f$ \Sigma' = \Sigma + e d^T + d e^T\f$ where \f$ e \f$ is the pos-th unit vector and \f$ d_{pos} \f$ is halved. This can be written as a rank-one update followed by a rank-one downdate \f$ \Sigma' = \Sigma + uu^T - ww^T\f$ with \f$ u = (e + d) / \sqrt{2}\f$ and \f$ w = (e - d) / \sqrt{2}\f$. Both can be performed on the cholesky decomposition in O(K^2) without any additional allocations. If the downdate is numerically unstable, we fall back to the full O(K^3) decomposition in-place.
+     * @param  cur_solution: The current summary
+     * @param  &x: The element which replaces the element at position pos
+     * @param  pos: The position of the element to be replaced. Caller has to make sure that pos < added
+     */
+    void replace(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) {
+        if (L_replace.size() != L.size()) {
+            L_replace = LowerTriangularMatrix(L.size());
+            krow.resize(L.size());
+            u.resize(L.size());
+            w.resize(L.size());
+        }
+
+        static const data_t sqrt_half = std::sqrt(0.5);
+        for (unsigned int i = 0; i < added; ++i) {
+            // The old entry \Sigma_{pos,i} of the kernel matrix
+            data_t kold = dot(L.row(pos), L.row(i), std::min(i, pos) + 1);
+            data_t d;
+            if (i == pos) {
+                krow[i] = sigma * 1.0 + kernel->operator()(x, x);
+                d = (krow[i] - kold) / 2.0;
+            } else {
+                krow[i] = kernel->operator()(cur_solution[i], x);
+                d = krow[i] - kold;
+            }
+            u[i] = d * sqrt_half;
+            w[i] = -d * sqrt_half;
+            std::copy(L.row(i), L.row(i) + i + 1, L_replace.row(i));
+        }
+        u[pos] += sqrt_half;
+        w[pos] += sqrt_half;
+
+        if (!cholesky_rank_one_update(L_replace, added, u.data(), 1) || !cholesky_rank_one_update(L_replace, added, w.data(), -1)) {
+            for (unsigned int i = 0; i < added; ++i) {
+                for (unsigned int j = 0; j <= i; ++j) {
+                    L_replace(i, j) = dot(L.row(i), L.row(j), j + 1);
+                }
+            }
+            for (unsigned int i = 0; i < added; ++i) {
+                L_replace(std::max(i, pos), std::min(i, pos)) = krow[i];
+            }
+            cholesky_inplace(L_replace, added);
+        }
+    }
+
 public:
 
     /**
@@ -49,9 +149,10 @@ public:
      * @param  &kernel: The kernel function
      * @param  sigma: The scaling constant for the kernel
      */
-    FastIVM(unsigned int K, Kernel const &kernel, data_t sigma) : IVM(kernel, sigma), kmat(K+1), L(K+1) {
+    FastIVM(unsigned int K, Kernel const &kernel, data_t sigma) : IVM(kernel, sigma), L(K+1), diag(K+1), L_replace(0) {
         added = 0;
         fval = 0;
+        last_valid = false;
     }
 
     /**
@@ -61,13 +162,14 @@ public:
      * @param  sigma: The scaling constant for the kernel
      */
     FastIVM(unsigned int K, std::function<data_t (std::vector<data_t> const &, std::vector<data_t> const &)> kernel, data_t sigma) 
-        : IVM(kernel, sigma), kmat(K+1), L(K+1) {
+        : IVM(kernel, sigma), L(K+1), diag(K+1), L_replace(0) {
         added = 0;
         fval = 0;
+        last_valid = false;
     }
 
     /**
-     * @brief  Peek operator for the FastIVM. For more details see SubmodularFunction. This function adds the vector of kernel evaluations to the current kernel matrix and performs a rank-1 update to the cholesky decomposition, if possible. When a new element is added (pos >= added) then the runtime is O(K^2) where K = cur_solution.size() and added is the number of previous `update` calls. If an existing element is replaced (pos < added), then the cholesky decomposition cannot be updated with a rank-1 update. In this case the runtime is O(K^3) since the cholesky decomposition is recomputed. 
+     * @brief  Peek operator for the FastIVM. For more details see SubmodularFunction. This function computes the vector of kernel evaluations and performs a rank-1 update to the cholesky decomposition, if possible. When a new element is added (pos >= added) then the runtime is O(K^2) where K = cur_solution.size() and added is the number of previous `update` calls. If an existing element is replaced (pos < added), then the cholesky decomposition is updated with a rank-1 update and a rank-1 downdate which also takes O(K^2). 
      * 
      * @param  cur_solution: The current summary
      * @param  &x: The element which should be added to the summary
@@ -75,72 +177,220 @@ public:
      * @retval The log-determinant of the kernel matrix, if x would be inserted at position pos in current_solution
      */
     data_t peek(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) override {
-        if (pos >= added) {
-            // Peek function value for last line
+        last_x = x;
+        last_pos = std::min(pos, added);
+        last_valid = true;
 
+        if (pos >= added) {
+            // Compute the kernel values of the new row and then the new row of the cholesky decomposition in-place
+            data_t * const row = L.row(added);
             for (unsigned int i = 0; i < added; ++i) {
-                data_t kval = kernel->operator()(cur_solution[i], x);
+                row[i] = kernel->operator()(cur_solution[i], x);
+            }
+            row[added] = sigma * 1.0 + kernel->operator()(x, x);
 
-                kmat(i, added) = kval;
-                kmat(added, i) = kval;
+            return solve_row();
+        } else {
+            replace(cur_solution, x, pos);
+            return log_det_from_cholesky(L_replace, added);
+        }
+    }
+
+    /**
+     * @brief  Computes the kernel values between x and all elements of the pool in one batch (see Kernel::block). The last entry of row is \f$ \Sigma_{xx} + \sigma \f$. For more details see SubmodularFunction.
+     * @param  pool: Pointers to the elements of the pool indexed by their slot. Unused slots are nullptr.
+     * @param  &x: The element which should be added to the summaries
+     * @param  row: The kernel values indexed by slot.
+     */
+    void pool_row(std::vector<std::vector<data_t> const *> const &pool, std::vector<data_t> const &x, std::vector<data_t> &row) override {
+        row.resize(pool.size() + 1);
+
+        batch_rows.assign(1, &x);
+        batch_cols.clear();
+        for (auto e : pool) {
+            if (e != nullptr) batch_cols.push_back(e);
+        }
+        if (batch_cols.size() > 0) {
+            kernel->block(batch_rows, batch_cols, row.data(), batch_cols.size());
+        }
+
+        // Scatter the kernel values to their slots. We go backwards, since the slot is never smaller than the compact index
+        unsigned int c = batch_cols.size();
+        for (unsigned int i = pool.size(); i-- > 0; ) {
+            if (pool[i] != nullptr) {
+                row[i] = row[--c];
             }
-            data_t kval = kernel->operator()(x, x);
-            kmat(added, added) = sigma * 1.0 + kval;
-
-            for (size_t j = 0; j <= added; j++) {
-                //data_t s = std::inner_product(&L[added * K], &L[added * K] + j, &L[j * K], static_cast<data_t>(0));
-                data_t s = std::inner_product(&L(added, 0), &L(added, j), &L(j,0), static_cast<data_t>(0));
-                if (added == j) {
-                    L(added, j) = std::sqrt(kmat(added, j) - s);
-                } else {
-                    L(added, j) = (1.0f / L(j, j) * (kmat(added, j) - s));
+        }
+        row[pool.size()] = sigma * 1.0 + kernel->operator()(x, x);
+    }
+
+    /**
+     * @brief  Same as `peek`, but takes the kernel values from the output of `pool_row` so that only the forward substitution is performed when x is appended. Replacements fall back to `peek`. For more details see SubmodularFunction.
+     * @param  cur_solution: The current summary
+     * @param  &x: The element which should be added to the summary
+     * @param  pos: The position at which the given element should be inserted.
+     * @param  row: The output of `pool_row` for x.
+     * @param  pool_ids: The slot of each element of the summary in the pool.
+     * @retval The log-determinant of the kernel matrix, if x would be inserted at position pos in current_solution
+     */
+    data_t peek_pooled(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos, std::vector<data_t> const &row, std::vector<unsigned int> const &pool_ids) override {
+        if (pos < added || row.empty()) {
+            return peek(cur_solution, x, pos);
+        }
+
+        last_x = x;
+        last_pos = added;
+        last_valid = true;
+
+        data_t * const lrow = L.row(added);
+        for (unsigned int i = 0; i < added; ++i) {
+            lrow[i] = row[pool_ids[i]];
+        }
+        lrow[added] = row.back();
+
+        return solve_row();
+    }
+
+    /**
+     * @brief  Returns an upper bound on the gain of x. The gain of x is the log of its conditional variance given the current summary. Due to submodularity, the gain of x w.r.t. any subset of the summary is an upper bound. We use the element e which has been added last to the summary:
+     * \f[
+     *     \log\left(\Sigma_{xx} + \sigma - \frac{\Sigma_{xe}^2}{\Sigma_{ee} + \sigma}\right) 
+     * \f]
+     * which is at most \f$ \log\left(\Sigma_{xx} + \sigma\right) \f$, i.e. the bound w.r.t. the empty set. This only requires two kernel evaluations instead of a full kernel row and the forward substitution in `peek`. The bound is enlarged slightly so that rounding errors never lead to a bound below the gain computed by `peek`. 
+     * @param  cur_solution: The current summary
+     * @param  &x: The element which should be added to the summary
+     * @retval An upper bound on the gain of x
+     */
+    data_t gain_upper_bound(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x) override {
+        data_t bound = sigma * 1.0 + kernel->operator()(x, x);
+        if (added > 0) {
+            data_t kval = kernel->operator()(cur_solution[added - 1], x);
+            bound -= kval * kval / diag[added - 1];
+        }
+        bound = std::log(bound);
+        return bound + 1e-8 * (1.0 + std::abs(bound));
+    }
+
+    /**
+     * @brief  Batched peek operator for the FastIVM. For more details see SubmodularFunction. Appending a candidate x to the summary adds the row \f$ l^T \f$ with \f$ Ll = k_x \f$ to the cholesky decomposition, where \f$ k_x \f$ are the kernel values between x and the summary. Instead of solving this triangular system for each candidate individually, we collect the kernel values of a block of candidates into a K x batch_size matrix (see Kernel::block) and solve the triangular system for all of them at once. The inner loop runs over the candidates, which is cache-friendly and can be vectorized by the compiler. If compiled with SSM_USE_BLAS, the triangular system is solved via BLAS (trsm). The runtime is O(K^2) per candidate as for `peek`, but the kernel matrix and the cholesky decomposition are not changed. 
+     * @param  cur_solution: The current summary
+     * @param  X: The data set from which the candidates are taken.
+     * @param  candidates: The indices of the candidates in X.
+     * @param  fvals: The log-determinants of the kernel matrix, if X[candidates[i]] would be appended to the summary.
+     */
+    void peek_batch(std::vector<std::vector<data_t>> const &cur_solution, std::vector<std::vector<data_t>> const &X, std::vector<unsigned int> const &candidates, std::vector<data_t> &fvals) override {
+        fvals.resize(candidates.size());
+        batch.resize(added * batch_size);
+
+        batch_rows.resize(added);
+        for (unsigned int i = 0; i < added; ++i) {
+            batch_rows[i] = &cur_solution[i];
+        }
+
+#ifdef SSM_USE_BLAS
+        L_unpacked.assign(added * added, 0);
+        for (unsigned int i = 0; i < added; ++i) {
+            std::copy(L.row(i), L.row(i) + i + 1, L_unpacked.begin() + i * added);
+        }
+#endif
+
+        for (unsigned int start = 0; start < candidates.size(); start += batch_size) {
+            unsigned int m = std::min(batch_size, static_cast<unsigned int>(candidates.size()) - start);
+
+            batch_cols.resize(m);
+            for (unsigned int c = 0; c < m; ++c) {
+                batch_cols[c] = &X[candidates[start + c]];
+            }
+            kernel->block(batch_rows, batch_cols, batch.data(), batch_size);
+
+#ifdef SSM_USE_BLAS
+            if (added > 0) {
+                blas_trsm_lower(L_unpacked.data(), added, batch.data(), batch_size, added, m);
+            }
+#else
+            // Forward substitution for each candidate as in solve_row. We first transpose the block, so that the solution of each candidate is contiguous and all inner products run over contiguous memory (see dot)
+            batch_t.resize(added * batch_size);
+            for (unsigned int i = 0; i < added; ++i) {
+                for (unsigned int c = 0; c < m; ++c) {
+                    batch_t[c * added + i] = batch[i * batch_size + c];
                 }
-                L(j, added) = L(added, j); // Symmetric update
             }
-            return fval + 2.0 * std::log(L(added, added));
-        } else {
-            Matrix tmp(kmat, added);
-            for (unsigned int i = 0; i < cur_solution.size(); ++i) {
-                if (i == pos) {
-                    data_t kval = kernel->operator()(x, x);
-                    tmp(pos, pos) = sigma * 1.0 + kval;
-                } else {
-                    data_t kval = kernel->operator()(cur_solution[i], x);
-                    tmp(i, pos) = kval;
-                    tmp(pos, i) = kval;
+            for (unsigned int c = 0; c < m; ++c) {
+                data_t * const v = batch_t.data() + c * added;
+                for (unsigned int i = 0; i < added; ++i) {
+                    v[i] = (v[i] - dot(L.row(i), v, i)) / L(i, i);
+                }
+                for (unsigned int i = 0; i < added; ++i) {
+                    batch[i * batch_size + c] = v[i];
                 }
             }
+#endif
 
-            return log_det(tmp);
+            for (unsigned int c = 0; c < m; ++c) {
+                std::vector<data_t> const &x = X[candidates[start + c]];
+                data_t d = sigma * 1.0 + kernel->operator()(x, x);
+                for (unsigned int i = 0; i < added; ++i) {
+                    d -= batch[i * batch_size + c] * batch[i * batch_size + c];
+                }
+                fvals[start + c] = fval + std::log(d);
+            }
         }
     }
 
     /**
-     * @brief  Update the current solution. Does the same as `peek` and additionally preserves any changes to the kernel matrix.  
+     * @brief  Update the current solution. Does the same as `peek` and additionally preserves any changes to the kernel matrix. If the last call to `peek` used the same element and position, then its results are committed without re-computing any kernel values. 
      * @param  cur_solution: The current summary
      * @param  &x: The element which should be added to the summary
      * @param  pos: The position at which the given element should be inserted. If pos >= cur_solution.size(), then x is appended. Otherwise it replaces the element at position pos
      */
     void update(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) override {
+        if (!is_last_peek(x, pos)) {
+            peek(cur_solution, x, pos);
+        }
+        last_valid = false;
+
         if (pos >= added) {
-            // TODO We often have the peek () -> update() pattern. This call can be optimized since we now basically peek twice
-            fval = peek(cur_solution, x, pos);
+            fval = fval + 2.0 * std::log(L(added, added));
+            diag[added] = dot(L.row(added), L.row(added), added + 1);
             added++;
         } else {
-            for (unsigned int i = 0; i < cur_solution.size(); ++i) {
-                if (i == pos) {
-                    data_t kval = kernel->operator()(x, x);
-                    kmat(pos, pos) = sigma * 1.0 + kval;
-                } else {
-                    data_t kval = kernel->operator()(cur_solution[i], x);
-                    kmat(i, pos) = kval;
-                    kmat(pos, i) = kval;
-                }
+            for (unsigned int i = 0; i < added; ++i) {
+                std::copy(L_replace.row(i), L_replace.row(i) + i + 1, L.row(i));
             }
-            L = cholesky(kmat, added);
-            fval = log_det_from_cholesky(L);
+            diag[pos] = krow[pos];
+            fval = log_det_from_cholesky(L, added);
+        }
+    }
+
+    /**
+     * @brief  Removes the element at position pos from the summary. Removing row / column pos from the kernel matrix removes row pos from the cholesky decomposition. The remaining rows are compacted and the lower right block, which lost the contribution of column pos, is restored by a rank-one update with the old column l below the diagonal, i.e. \f$ L'_{33} L'^T_{33} = L_{33} L^T_{33} + l l^T \f$. An update (unlike a downdate) is always numerically stable and the runtime is O(K^2).
+     * @param  cur_solution: The current summary before the element is removed
+     * @param  pos: The position of the element which is removed. If pos >= added, nothing happens.
+     */
+    void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) override {
+        if (pos >= added) {
+            return;
         }
+        last_valid = false;
 
+        if (u.size() != L.size()) {
+            u.resize(L.size());
+        }
+        std::fill(u.begin(), u.begin() + pos, 0);
+
+        // Row i moves to row i - 1 and drops column pos. The packed rows do not overlap, so we can move them front-to-back.
+        for (unsigned int i = pos + 1; i < added; ++i) {
+            data_t const * const src = L.row(i);
+            data_t * const dst = L.row(i - 1);
+            u[i - 1] = src[pos];
+            std::copy(src, src + pos, dst);
+            std::copy(src + pos + 1, src + i + 1, dst + pos);
+        }
+        std::copy(diag.begin() + pos + 1, diag.begin() + added, diag.begin() + pos);
+        added--;
+
+        cholesky_rank_one_update(L, added, u.data(), 1);
+        fval = log_det_from_cholesky(L, added);
     }
 
     /**
@@ -159,9 +409,21 @@ public:
      * @retval The cloned object.
      */
     std::shared_ptr<SubmodularFunction> clone() const override {
-        // We want to store k elements. To allow for efficient peeking we will reserve space for K + 1 elements in kmat and L. 
+        // We want to store k elements. To allow for efficient peeking we will reserve space for K + 1 elements in L. 
         // Thus we need to call the constructor with one element less
-        return std::make_shared<FastIVM>(kmat.size() - 1, *kernel, sigma);
+        return std::make_shared<FastIVM>(L.size() - 1, *kernel, sigma);
+    }
+
+    /**
+     * @brief  Copies the current object including the cholesky decomposition in O(K^2). For more details see SubmodularFunction.
+     * @note   Calls the clone method of the given kernel, similar to `clone`.
+     * @param  cur_solution: The current summary
+     * @retval The copied object.
+     */
+    std::shared_ptr<SubmodularFunction> copy(std::vector<std::vector<data_t>> const &cur_solution) const override {
+        auto f = std::make_shared<FastIVM>(*this);
+        f->kernel = kernel->clone();
+        return f;
     }
 };
 
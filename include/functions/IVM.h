@@ -113,6 +113,14 @@ public:
      */
     void update(std::vector<std::vector<data_t>> const &cur_solution, std::vector<data_t> const &x, unsigned int pos) override {}
 
+    /**
+     * @brief  Does nothing and only exists for compatibility reasons.
+     * @param  &cur_solution: 
+     * @param  pos: 
+     * @retval None
+     */
+    void remove(std::vector<std::vector<data_t>> const &cur_solution, unsigned int pos) override {}
+
     /**
      * @brief  Computes the kernel matrix \Sigma + \sigma \cdot \mathcal I between all pairs in X and its log-determinant.  The runtime is O(K^3) where K = X.size().
      * @note   The log-determinant is computed via a cholesky decomposition.
@@ -124,9 +132,25 @@ public:
         // I would not use this for any real-world problems. 
         
         Matrix kernel_mat = compute_kernel(X, sigma);
-        return log_det(kernel_mat);
+        return log_det_inplace(kernel_mat, kernel_mat.size());
     } 
 
+    /**
+     * @brief  Returns the kernel of this IVM.
+     * @retval A const reference to the kernel
+     */
+    Kernel const & get_kernel() const {
+        return *kernel;
+    }
+
+    /**
+     * @brief  Returns the scaling constant sigma of this IVM.
+     * @retval The scaling constant
+     */
+    data_t get_sigma() const {
+        return sigma;
+    }
+
     /**
      * @brief  Clones the current IVM object.
      * @note   Calls the clone method of the given kernel. If the kernel implements a deep-copy, then this clone operation is also a deep -opy. Otherwise it is not.
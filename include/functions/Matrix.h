@@ -3,8 +3,52 @@
 
 #include <immintrin.h>
 #include <vector>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <string>
+#include <limits>
 
 #include "DataTypeHandling.h"
+#include "functions/BLAS.h"
+
+/**
+ * @brief  A minimal allocator for std::vector which aligns the allocated memory to the given boundary (in bytes). The Matrix class uses this to align its storage to cache lines, so that the beginning of the matrix can be loaded with aligned SIMD instructions.
+ */
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(AlignedAllocator<U, Alignment> const &) noexcept {}
+
+    T * allocate(std::size_t n) {
+        // std::aligned_alloc requires the size to be a multiple of the alignment
+        std::size_t bytes = ((n * sizeof(T) + Alignment - 1) / Alignment) * Alignment;
+        void * ptr = std::aligned_alloc(Alignment, bytes);
+        if (ptr == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(ptr);
+    }
+
+    void deallocate(T * ptr, std::size_t) noexcept {
+        std::free(ptr);
+    }
+
+    template <typename U>
+    bool operator==(AlignedAllocator<U, Alignment> const &) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(AlignedAllocator<U, Alignment> const &) const noexcept { return false; }
+};
 
 /**
  * @brief  This is a simple Matrix class for quadratic \f$ N \times N \f$ matrices. The Matrix is implemented with a 1d (column major) `std::vector`. There are also some linear algebra functions available
@@ -18,7 +62,8 @@ private:
     // There are two main reasons why we use an std::vector here instead of a raw pointer
     //  (1) std::vector is the more modern c++ style and raw pointers are somewhat discouraged (see next comment)
     //  (2) It turns our there is a good reason why we should not use raw pointers. It makes it really difficult to implement appropriate copy / move constructors. I would sometimes run into weird memory issues, because the compiler provided an implicit copy / move c'tor. Of course it would be possible to properly implement move/copy/assignment operators (rule of 0/3/5 https://en.cppreference.com/w/cpp/language/rule_of_three) but that's more work than I need. 
-    std::vector<data_t> data;
+    // The storage is aligned to 64 bytes (see AlignedAllocator).
+    std::vector<data_t, AlignedAllocator<data_t>> data;
 
 public:
 
@@ -30,9 +75,7 @@ public:
      */
     Matrix(Matrix const &other, unsigned int N_sub) : N(N_sub), data(N_sub * N_sub) {
         for (unsigned int i = 0; i < N_sub; ++i) {
-            for (unsigned int j = 0; j < N_sub; ++j) {
-                this->operator()(i, j) = other(i,j);
-            }
+            std::copy(other.row(i), other.row(i) + N_sub, row(i));
         }
     }
 
@@ -110,6 +153,22 @@ public:
      */
     data_t operator [](int i) const {return data[i*N];}
 
+    /**
+     * @brief  Returns a pointer to the first element of the i-th row of the matrix. Caller has to make sure that i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @retval A pointer to the i-th row
+     */
+    data_t * row(unsigned int i) { return &data[i*N]; }
+
+    /**
+     * @brief  Returns a pointer to the first element of the i-th row of the matrix. Caller has to make sure that i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @retval A pointer to the i-th row
+     */
+    data_t const * row(unsigned int i) const { return &data[i*N]; }
+
     /**
      * @brief  Access the i-th row and j-th column of the matrix. Caller has to make sure that i, j < N.
      * @note   There are no safety checks performed.
@@ -129,6 +188,66 @@ public:
     data_t operator()(int i, int j) const { return data[i*N+j]; }
 };
 
+/**
+ * @brief  A lower triangular \f$ N \times N \f$ matrix in packed storage. Only the \f$ N(N+1)/2 \f$ entries on and below the diagonal are stored row after row, i.e. the i-th row starts at i(i+1)/2 and has i + 1 entries. Thus, each row is contiguous in memory and appending a new row (e.g. to a cholesky decomposition) touches only one contiguous block. 
+ */
+class LowerTriangularMatrix {
+private:
+
+    // The size of the matrix
+    unsigned int N;
+
+    // The packed entries, aligned to 64 bytes (see AlignedAllocator).
+    std::vector<data_t, AlignedAllocator<data_t>> data;
+
+public:
+
+    /**
+     * @brief  Creates a new _size x _size lower triangular matrix. The matrix elements are initialized with zeros.
+     * @param  _size: The number of rows / columns of the matrix.
+     */
+    LowerTriangularMatrix(unsigned int _size) : N(_size), data(static_cast<size_t>(_size) * (_size + 1) / 2, 0) {}
+
+    /**
+     * @brief  Returns the number of row / columns of the matrix
+     */
+    inline unsigned int size() const { return N; }
+
+    /**
+     * @brief  Returns a pointer to the first element of the i-th row of the matrix. The row has i + 1 entries. Caller has to make sure that i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @retval A pointer to the i-th row
+     */
+    data_t * row(unsigned int i) { return &data[static_cast<size_t>(i) * (i + 1) / 2]; }
+
+    /**
+     * @brief  Returns a pointer to the first element of the i-th row of the matrix. The row has i + 1 entries. Caller has to make sure that i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @retval A pointer to the i-th row
+     */
+    data_t const * row(unsigned int i) const { return &data[static_cast<size_t>(i) * (i + 1) / 2]; }
+
+    /**
+     * @brief  Access the i-th row and j-th column of the matrix. Caller has to make sure that j <= i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @param  j:  The column to be accessed
+     * @retval A reference to the (i,j) entry of the matrix
+     */
+    data_t & operator()(int i, int j) { return data[static_cast<size_t>(i) * (i + 1) / 2 + j]; }
+
+    /**
+     * @brief  Access the i-th row and j-th column of the matrix. Caller has to make sure that j <= i < N.
+     * @note   There are no safety checks performed.
+     * @param  i:  The row to be accessed
+     * @param  j:  The column to be accessed
+     * @retval The (i,j) entry of the matrix
+     */
+    data_t operator()(int i, int j) const { return data[static_cast<size_t>(i) * (i + 1) / 2 + j]; }
+};
+
 /**
  * @brief  Converts the given (sub-)matrix into a python / numpy compatible string, e.g. you can copy this string directly into the interactive python console for debugging if necessary. If you want to print the entire matrix supply N_sub = N.
  * @param  &mat: The matrix which should ne converted to a string.
@@ -168,31 +287,120 @@ inline std::string to_string(Matrix const &mat) {
 }
 
 /**
- * @brief  Computes the choleksy decomposition of the N_sub x N_sub sub matrix and returns the lower triangular matrix L with LL^T = in.
- * @param  &in: The matrix which should be decomposed.
- * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to print the entire matrix supply N_sub = N.
- * @retval Returns the cholesky decomposition
+ * @brief  Computes the inner product of the first n elements of x and y. This is the work-horse of the cholesky decomposition below. If AVX is available, then four doubles are processed at once with two independent accumulators. Otherwise, we use four independent scalar accumulators which breaks the dependency chain of the sum and lets the compiler vectorize the loop.
+ * @param  x: The first vector
+ * @param  y: The second vector
+ * @param  n: The number of elements
+ * @retval The inner product of x and y
  */
-inline Matrix cholesky(Matrix const &in, unsigned int N_sub) {
-    Matrix L(in, N_sub);
+inline data_t dot(data_t const * x, data_t const * y, unsigned int n) {
+    unsigned int i = 0;
+    data_t sum = 0;
+
+#if defined(__AVX__)
+    if constexpr (std::is_same<data_t, double>::value) {
+        __m256d acc1 = _mm256_setzero_pd();
+        __m256d acc2 = _mm256_setzero_pd();
+        for (; i + 8 <= n; i += 8) {
+#if defined(__FMA__)
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), acc1);
+            acc2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), acc2);
+#else
+            acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+            acc2 = _mm256_add_pd(acc2, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+#endif
+        }
+        acc1 = _mm256_add_pd(acc1, acc2);
+        alignas(32) double tmp[4];
+        _mm256_store_pd(tmp, acc1);
+        sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+    }
+#endif
+
+    data_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += x[i] * y[i];
+    }
+    return sum + (s0 + s1) + (s2 + s3);
+}
 
-    for (unsigned int j = 0; j < N_sub; ++j) {
-        data_t sum = 0.0;
+/**
+ * @brief  Computes the choleksy decomposition of the N_sub x N_sub sub matrix in-place. Afterwards, the lower triangle (including the diagonal) of A holds the lower triangular matrix L with LL^T = A. The upper triangle is not touched. No memory is allocated.
+ * @note   The decomposition is blocked: We process block_size columns at a time and compute the diagonal block first and then the entries of all remaining rows in these columns. Since the matrix is stored row-major, every entry is computed by an inner product of two contiguous rows (see dot). The block_size rows of the current diagonal block are re-used for all rows below and stay in the cache. If A is not positive definite, then the diagonal contains NaNs. 
+ * @param  &A: The matrix which should be decomposed. This can either be a Matrix or a LowerTriangularMatrix.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to decompose the entire matrix supply N_sub = N.
+ */
+template <typename MatrixType>
+inline void cholesky_inplace(MatrixType &A, unsigned int N_sub) {
+    static constexpr unsigned int block_size = 64;
+
+    for (unsigned int jb = 0; jb < N_sub; jb += block_size) {
+        unsigned int je = std::min(jb + block_size, N_sub);
+
+        // Diagonal block
+        for (unsigned int i = jb; i < je; ++i) {
+            data_t * const Ai = A.row(i);
+            for (unsigned int j = jb; j < i; ++j) {
+                Ai[j] = (Ai[j] - dot(Ai, A.row(j), j)) / A(j, j);
+            }
+            Ai[i] = std::sqrt(Ai[i] - dot(Ai, Ai, i));
+        }
 
-        for (unsigned int k = 0; k < j; ++k) {
-            sum += L(j,k)*L(j,k);
+        // All rows below the diagonal block
+        for (unsigned int i = je; i < N_sub; ++i) {
+            data_t * const Ai = A.row(i);
+            for (unsigned int j = jb; j < je; ++j) {
+                Ai[j] = (Ai[j] - dot(Ai, A.row(j), j)) / A(j, j);
+            }
         }
+    }
+}
 
-        L(j,j) = std::sqrt(in(j,j) - sum);
+#ifdef SSM_USE_BLAS
+/**
+ * @brief  Computes the choleksy decomposition of the N_sub x N_sub sub matrix in-place via LAPACK (see cholesky_inplace above for details). If A is not positive definite, then the diagonal contains NaNs.
+ * @param  &A: The matrix which should be decomposed.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to decompose the entire matrix supply N_sub = N.
+ */
+inline void cholesky_inplace(Matrix &A, unsigned int N_sub) {
+    if (N_sub == 0) return;
+    int info = blas_potrf(A.row(0), N_sub, A.size());
+    if (info > 0) {
+        A(info - 1, info - 1) = std::numeric_limits<data_t>::quiet_NaN();
+    }
+}
 
-        for (unsigned int i = j + 1; i < N_sub; ++i) {
-            data_t sum = 0.0;
+/**
+ * @brief  Computes the choleksy decomposition of the N_sub x N_sub sub matrix of the packed matrix in-place via LAPACK (see cholesky_inplace above for details). If A is not positive definite, then the diagonal contains NaNs.
+ * @param  &A: The packed matrix which should be decomposed.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to decompose the entire matrix supply N_sub = N.
+ */
+inline void cholesky_inplace(LowerTriangularMatrix &A, unsigned int N_sub) {
+    if (N_sub == 0) return;
+    int info = blas_pptrf(A.row(0), N_sub);
+    if (info > 0) {
+        A(info - 1, info - 1) = std::numeric_limits<data_t>::quiet_NaN();
+    }
+}
+#endif
 
-            for (unsigned int k = 0; k < j; ++k) {
-                sum += L(i,k) * L(j,k);
-            }
-            L(i,j) = (in(i,j) - sum) / L(j,j);
-        }
+/**
+ * @brief  Computes the choleksy decomposition of the N_sub x N_sub sub matrix and returns the lower triangular matrix L with LL^T = in.
+ * @param  &in: The matrix which should be decomposed.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to print the entire matrix supply N_sub = N.
+ * @retval Returns the cholesky decomposition
+ */
+inline Matrix cholesky(Matrix const &in, unsigned int N_sub) {
+    Matrix L(in, N_sub);
+    cholesky_inplace(L, N_sub);
+    for (unsigned int i = 0; i < N_sub; ++i) {
+        std::fill(L.row(i) + i + 1, L.row(i) + N_sub, 0);
     }
     return L;
 }
@@ -220,14 +428,89 @@ inline data_t log_det_from_cholesky(Matrix const &L) {
 }
 
 /**
- * @brief  Computes the log-determinant of the N_sub x N_sub sub-matrix of the given matrix mat  
+ * @brief  Computes the log-determinant from the N_sub x N_sub sub-matrix of the lower triangular matrix L which previously has been computed via a cholesky decomposition
+ * @param  &L: The lower triangular matrix with LL^T = in, where in is the original matrix. This can either be a Matrix or a LowerTriangularMatrix.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N.
+ * @retval The log-determinant of the N_sub x N_sub sub-matrix of in
+ */
+template <typename MatrixType>
+inline data_t log_det_from_cholesky(MatrixType const &L, unsigned int N_sub) {
+    data_t det = 0;
+
+    for (size_t i = 0; i < N_sub; ++i) {
+        det += std::log(L(i,i));
+    }
+
+    return 2*det;
+}
+
+/**
+ * @brief  Performs a rank-one update (sign = 1) or downdate (sign = -1) of the N_sub x N_sub cholesky decomposition L in-place, so that afterwards it holds LL^T = in + sign * v v^T. The runtime is O(N_sub^2) and no memory is allocated.
+ * @note   The vector v is used as scratch space and is overwritten. A downdate fails if the resulting matrix is not positive definite (anymore). In this case, L is left in an unspecified state and must be recomputed.
+ * @param  &L: The lower triangular matrix with LL^T = in, where in is the original matrix. This can either be a Matrix or a LowerTriangularMatrix.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N.
+ * @param  v: The vector of the rank-one update. Caller has to make sure that v has at-least N_sub elements.
+ * @param  sign: 1 for an update and -1 for a downdate.
+ * @retval True if the update was successful and false otherwise.
+ */
+template <typename MatrixType>
+inline bool cholesky_rank_one_update(MatrixType &L, unsigned int N_sub, data_t * const v, data_t sign) {
+    for (unsigned int k = 0; k < N_sub; ++k) {
+        data_t r2 = L(k,k)*L(k,k) + sign * v[k]*v[k];
+        if (r2 <= 0) {
+            return false;
+        }
+
+        data_t r = std::sqrt(r2);
+        data_t c = r / L(k,k);
+        data_t s = v[k] / L(k,k);
+        L(k,k) = r;
+
+        for (unsigned int i = k + 1; i < N_sub; ++i) {
+            L(i,k) = (L(i,k) + sign * s * v[i]) / c;
+            v[i] = c * v[i] - s * L(i,k);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief  Computes the log-determinant of the N_sub x N_sub sub-matrix of the given matrix mat in-place. Afterwards, mat holds the cholesky decomposition of its sub-matrix (see cholesky_inplace). No memory is allocated.
+ * @param  &mat: The base matrix from which the N_sub x N_sub sub-matrix is used.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to use the entire matrix supply N_sub = N.
+ * @retval The log-determinant of the  N_sub x N_sub sub-matrix of mat
+ */
+inline data_t log_det_inplace(Matrix &mat, unsigned int N_sub) {
+    cholesky_inplace(mat, N_sub);
+    return log_det_from_cholesky(mat, N_sub);
+}
+
+/**
+ * @brief  Computes the log-determinant of the N_sub x N_sub sub-matrix of the given matrix mat by using the caller-supplied workspace. No memory is allocated if the workspace is large enough.
+ * @param  &mat: The base matrix from which the N_sub x N_sub sub-matrix is used.
+ * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to use the entire matrix supply N_sub = N.
+ * @param  &workspace: The workspace for the cholesky decomposition. If it has less than N_sub rows / columns it is replaced by a N_sub x N_sub matrix.
+ * @retval The log-determinant of the  N_sub x N_sub sub-matrix of mat
+ */
+inline data_t log_det(Matrix const &mat, unsigned int N_sub, Matrix &workspace) {
+    if (workspace.size() < N_sub) {
+        workspace = Matrix(N_sub);
+    }
+    for (unsigned int i = 0; i < N_sub; ++i) {
+        std::copy(mat.row(i), mat.row(i) + i + 1, workspace.row(i));
+    }
+    return log_det_inplace(workspace, N_sub);
+}
+
+/**
+ * @brief  Computes the log-determinant of the N_sub x N_sub sub-matrix of the given matrix mat
  * @param  &mat: The base matrix from which the N_sub x N_sub sub-matrix is used.
  * @param  N_sub: The N_sub x N_sub sub-matrix. The caller has to make sure that N_sub <= N. If you want to use the entire matrix supply N_sub = N.
  * @retval The log-determinant of the  N_sub x N_sub sub-matrix of mat
  */
 inline data_t log_det(Matrix const &mat, unsigned int N_sub) {
-    Matrix L = cholesky(mat, N_sub);
-    return log_det_from_cholesky(L);
+    Matrix L(mat, N_sub);
+    return log_det_inplace(L, N_sub);
 }
 
 /**
@@ -2,6 +2,9 @@
 #define KERNEL_H
 
 #include <cassert>
+#include <functional>
+#include <memory>
+#include <vector>
 #include "DataTypeHandling.h"
 
 /**
@@ -25,6 +28,21 @@ public:
      */
     virtual std::shared_ptr<Kernel> clone() const = 0;
 
+    /**
+     * @brief  Evaluates the kernel on all pairs of the given elements and stores the results row-major in out, i.e. out[i * ld + j] = k(*X1[i], *X2[j]). The default implementation simply evaluates the kernel for each pair. Kernels can override this method to compute the entire block at once, e.g. via matrix-matrix products.
+     * @param  X1: Pointers to the first arguments of the kernel.
+     * @param  X2: Pointers to the second arguments of the kernel.
+     * @param  out: The output. Caller has to make sure that out has at-least X1.size() * ld entries.
+     * @param  ld: The leading dimension (row stride) of out. Caller has to make sure that ld >= X2.size()
+     */
+    virtual void block(std::vector<std::vector<data_t> const *> const &X1, std::vector<std::vector<data_t> const *> const &X2, data_t * out, unsigned int ld) const {
+        for (unsigned int i = 0; i < X1.size(); ++i) {
+            for (unsigned int j = 0; j < X2.size(); ++j) {
+                out[i * ld + j] = this->operator()(*X1[i], *X2[j]);
+            }
+        }
+    }
+
     /**
      * @brief  Destroys the current kernel.
      */
@@ -81,4 +99,53 @@ public:
 
 };
 
+/**
+ * @brief  A wrapper around a raw C function pointer with the signature `data_t kernel(data_t const * x1, data_t const * x2, idx_t dim)`. In contrast to the KernelWrapper, the function pointer is called directly without any further indirection which makes it possible to use native code from other languages such as `numba.cfunc` or `ctypes` callbacks from Python. Kernels implemented this way never touch the Python interpreter (and therefore never acquire the GIL) and run at the same speed as a kernel implemented in C++. For example:
+        data_t linear(data_t const * x1, data_t const * x2, idx_t dim) {
+            data_t dot = 0;
+            for (idx_t i = 0; i < dim; ++i) {
+                dot += x1[i]*x2[i];
+            }
+            return dot;
+        }
+        NativeKernel kernel(linear);
+ * @note   The function pointer must be stateless and thread-safe, since clones of this kernel share the same function pointer.
+ */
+class NativeKernel : public Kernel {
+public:
+    // The signature of a native kernel function. The first two arguments point to the data of x1 and x2, the third argument is their dimension.
+    typedef data_t (*kernel_ptr)(data_t const *, data_t const *, idx_t);
+
+protected:
+    // The wrapped function pointer.
+    kernel_ptr f;
+
+public:
+
+    /**
+     * @brief  Creates a new NativeKernel object.
+     * @param  f: The function pointer to be wrapped. Must not be a nullptr.
+     */
+    NativeKernel(kernel_ptr f) : f(f) {
+        assert(("The function pointer of a NativeKernel should not be a nullptr!", f != nullptr));
+    }
+
+    /**
+     * @brief  Evaluates the wrapped function pointer on the given parameters.
+     * @param  x1: First parameter for evaluation.
+     * @param  x2: Second parameter for evaluation.
+     */
+    inline data_t operator()(const std::vector<data_t>& x1, const std::vector<data_t>& x2) const override {
+        return f(x1.data(), x2.data(), static_cast<idx_t>(x1.size()));
+    }
+
+    /**
+     * @brief  Clones this objet.
+     * @note   This is a deep copy, since only the function pointer is copied.
+     */
+    std::shared_ptr<Kernel> clone() const override {
+        return std::shared_ptr<Kernel>(new NativeKernel(f));
+    }
+};
+
 #endif // RBF_KERNEL_H
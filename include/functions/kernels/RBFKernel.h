@@ -5,9 +5,12 @@
 #include <algorithm>
 #include <numeric>
 #include <vector>
+#include <cmath>
+#include <limits>
 #include <x86intrin.h>
 
 #include "DataTypeHandling.h"
+#include "functions/BLAS.h"
 #include "functions/kernels/Kernel.h"
 
 /* These are remains of an AVX implementation for the euclidean distance. However, it was not much faster (sometimes slower)
@@ -141,6 +144,43 @@ public:
         return scale * std::exp(-distance);
     }
 
+#ifdef SSM_USE_BLAS
+    /**
+     * @brief  Evaluates the kernel on all pairs of the given elements (see Kernel::block). We use \f$ \|x_1 - x_2\|_2^2 = \|x_1\|_2^2 + \|x_2\|_2^2 - 2 x_1^Tx_2 \f$ so that all inner products can be computed with a single matrix-matrix product via BLAS. Distances which are zero up to rounding errors are set to zero, so that identical elements have a kernel value of exactly scale. 
+     * @param  X1: Pointers to the first arguments of the kernel.
+     * @param  X2: Pointers to the second arguments of the kernel.
+     * @param  out: The output. Caller has to make sure that out has at-least X1.size() * ld entries.
+     * @param  ld: The leading dimension (row stride) of out. Caller has to make sure that ld >= X2.size()
+     */
+    void block(std::vector<std::vector<data_t> const *> const &X1, std::vector<std::vector<data_t> const *> const &X2, data_t * out, unsigned int ld) const override {
+        if (X1.size() == 0 || X2.size() == 0) return;
+
+        unsigned int d = X1[0]->size();
+        std::vector<data_t> A(X1.size() * d), B(X2.size() * d), n1(X1.size()), n2(X2.size());
+        for (unsigned int i = 0; i < X1.size(); ++i) {
+            std::copy(X1[i]->begin(), X1[i]->end(), A.begin() + i * d);
+            n1[i] = std::inner_product(X1[i]->begin(), X1[i]->end(), X1[i]->begin(), data_t(0));
+        }
+        for (unsigned int j = 0; j < X2.size(); ++j) {
+            std::copy(X2[j]->begin(), X2[j]->end(), B.begin() + j * d);
+            n2[j] = std::inner_product(X2[j]->begin(), X2[j]->end(), X2[j]->begin(), data_t(0));
+        }
+
+        blas_gemm_nt(A.data(), B.data(), out, X1.size(), X2.size(), d, ld);
+
+        data_t const eps = 4 * std::numeric_limits<data_t>::epsilon();
+        for (unsigned int i = 0; i < X1.size(); ++i) {
+            for (unsigned int j = 0; j < X2.size(); ++j) {
+                data_t distance = n1[i] + n2[j] - 2 * out[i * ld + j];
+                if (distance <= eps * (n1[i] + n2[j])) {
+                    distance = 0;
+                }
+                out[i * ld + j] = scale * std::exp(-distance / sigma);
+            }
+        }
+    }
+#endif
+
     /**
      * @brief  Returns a clone of this kernel. 
      * @note   The clone is a deep copy of this kernel. 
@@ -57,6 +57,10 @@ class CMakeBuild(build_ext):
             if "CXX" in os.environ:
                 cmake_args += ['-DCMAKE_CXX_COMPILER=' + os.environ["CXX"]]
 
+        # Set SSM_USE_BLAS=1 to use a local BLAS / LAPACK installation (see CMakeLists.txt)
+        if os.environ.get("SSM_USE_BLAS", "0") not in ["", "0", "OFF", "off"]:
+            cmake_args += ['-DSSM_USE_BLAS=ON']
+
         env = os.environ.copy()
         env['CXXFLAGS'] = '{} -DVERSION_INFO=\\"{}\\"'.format(env.get('CXXFLAGS', ''),
                                                               self.distribution.get_version())
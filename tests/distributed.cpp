@@ -0,0 +1,151 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <memory>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "functions/FastIVM.h"
+#include "functions/kernels/RBFKernel.h"
+#include "ThreeSieves.h"
+#include "SieveStreaming.h"
+#include "DataTypeHandling.h"
+#include "distributed/Snapshot.h"
+#include "distributed/UnixSocketTransport.h"
+#include "distributed/StreamWorker.h"
+#include "distributed/Coordinator.h"
+
+// Hands the messages directly to a coordinator in the same process
+class LocalSender : public Sender {
+private:
+    Coordinator & coordinator;
+
+public:
+    LocalSender(Coordinator & coordinator) : coordinator(coordinator) {}
+
+    void send(std::vector<char> const & message) {
+        coordinator.add(deserialize(message));
+    }
+};
+
+std::unique_ptr<SubmodularOptimizer> make_optimizer(unsigned int worker, unsigned int K, SubmodularFunction & f) {
+    if (worker % 2 == 0) {
+        return std::make_unique<ThreeSieves>(K, f, 1.0, 0.01, "sieve", 20);
+    } else {
+        return std::make_unique<SieveStreaming>(K, f, 1.0, 0.1);
+    }
+}
+
+// Streams the partition of the given worker, i.e. all elements X[i] with i % P == worker
+void run_worker(unsigned int worker, unsigned int P, unsigned int K, SubmodularFunction & f, std::vector<std::vector<data_t>> const & X, Sender & sender) {
+    auto opt = make_optimizer(worker, K, f);
+    StreamWorker w(*opt, sender, worker, 100);
+    for (unsigned int i = worker; i < X.size(); i += P) {
+        w.next(X[i], i);
+    }
+    w.finish();
+}
+
+int main() {
+    unsigned int N = 2000, dim = 5, K = 10, P = 4;
+
+    std::default_random_engine generator(12345);
+    std::normal_distribution<data_t> normal(0.0, 1.0);
+    std::vector<std::vector<data_t>> X(N, std::vector<data_t>(dim));
+    for (auto & x : X) {
+        for (auto & xi : x) {
+            xi = normal(generator);
+        }
+    }
+
+    FastIVM ivm(K, RBFKernel(std::sqrt(dim), 1.0), 1.0);
+    bool failed = false;
+
+    // The (de-)serialization should be lossless
+    Snapshot s;
+    s.worker = 3;
+    s.sequence = 7;
+    s.final = true;
+    s.fval = 1.5;
+    s.solution = {X[0], X[1]};
+    s.ids = {0, 1};
+    Snapshot s2 = deserialize(serialize(s));
+    if (s2.worker != s.worker || s2.sequence != s.sequence || s2.final != s.final || s2.fval != s.fval || s2.solution != s.solution || s2.ids != s.ids) {
+        failed = true;
+        std::cout << "TEST FAILED. Deserialized snapshot does not match the original snapshot." << std::endl;
+    }
+
+    // Run all workers in this process as a reference
+    Coordinator reference(K, ivm);
+    {
+        LocalSender sender(reference);
+        for (unsigned int w = 0; w < P; ++w) {
+            run_worker(w, P, K, ivm, X, sender);
+        }
+    }
+    reference.merge();
+
+    // Run each worker in its own process and ship the snapshots over a Unix socket
+    std::string path = "/tmp/ssm_distributed_test_" + std::to_string(getpid()) + ".sock";
+    Coordinator coordinator(K, ivm);
+    {
+        UnixSocketReceiver receiver(path, P);
+        std::vector<pid_t> children;
+        for (unsigned int w = 0; w < P; ++w) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                int status = 0;
+                try {
+                    UnixSocketSender sender(path);
+                    run_worker(w, P, K, ivm, X, sender);
+                } catch (std::exception const & e) {
+                    std::cout << "Worker " << w << " failed: " << e.what() << std::endl;
+                    status = 1;
+                }
+                _exit(status);
+            }
+            children.push_back(pid);
+        }
+
+        coordinator.run(receiver);
+        for (auto pid : children) {
+            int status;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                failed = true;
+                std::cout << "TEST FAILED. A worker process did not exit normally." << std::endl;
+            }
+        }
+    }
+    coordinator.merge();
+
+    std::cout << "Testing distributed summarization with " << P << " worker processes" << std::endl;
+    std::cout << "\tfval is " << coordinator.get_fval() << std::endl;
+
+    if (coordinator.get_num_workers() != P || !coordinator.all_final()) {
+        failed = true;
+        std::cout << "\tTEST FAILED. The final snapshots of some workers are missing." << std::endl;
+    }
+
+    if (coordinator.get_solution().size() != K || coordinator.get_fval() != reference.get_fval() || coordinator.get_ids() != reference.get_ids()) {
+        failed = true;
+        std::cout << "\tTEST FAILED. Solution does not match the solution computed in a single process!" << std::endl;
+    }
+
+    for (unsigned int i = 0; i < coordinator.get_ids().size(); ++i) {
+        if (X[coordinator.get_ids()[i]] != coordinator.get_solution()[i]) {
+            failed = true;
+            std::cout << "\tTEST FAILED. The ids do not match the solution!" << std::endl;
+            break;
+        }
+    }
+
+    if (failed) {
+        return 1;
+    } else {
+        std::cout << "\tTEST PASSED." << std::endl;
+        return 0;
+    }
+}
@@ -7,6 +7,11 @@
 #include "functions/FastIVM.h"
 #include "functions/kernels/RBFKernel.h"
 #include "Greedy.h"
+#include "IVMGreedy.h"
+#include "LazyGreedy.h"
+#include "StochasticGreedy.h"
+#include "ParallelGreedy.h"
+#include "PartitionedGreedy.h"
 #include "Random.h"
 #include "ThreeSieves.h"
 #include "Salsa.h"
@@ -37,6 +42,14 @@ data_t poly_kernel(std::vector<data_t>const & x1, std::vector<data_t> const & x2
     return distance / static_cast<data_t>(x1.size());
 }
 
+data_t native_poly_kernel(data_t const * x1, data_t const * x2, idx_t dim) {
+    data_t distance = 0;
+    for (idx_t i = 0; i < dim; ++i) {
+        distance += x1[i]*x2[i];
+    }
+    return distance / static_cast<data_t>(dim);
+}
+
 class PolyKernel : public Kernel {
    public:
       PolyKernel() = default;
@@ -72,7 +85,15 @@ inline data_t ivm(std::vector<std::vector<data_t>> const &cur_solution) {
             }
         }
     }
-    return log_det(kmat, cur_solution.size());
+    return log_det_inplace(kmat, cur_solution.size());
+}
+
+data_t native_ivm(data_t const * X, idx_t n, idx_t dim) {
+    std::vector<std::vector<data_t>> cur_solution(n);
+    for (idx_t i = 0; i < n; ++i) {
+        cur_solution[i] = std::vector<data_t>(X + i*dim, X + (i+1)*dim);
+    }
+    return ivm(cur_solution);
 }
 
 class FastLogDet : public SubmodularFunction {
@@ -208,8 +229,11 @@ int main() {
     FastIVM ivm_custom_kernel_class(K, PolyKernel(), 1.0);
     FastIVM ivm_custom_kernel_function(K, poly_kernel, 1.0);
 
+    FastIVM ivm_native_kernel(K, NativeKernel(native_poly_kernel), 1.0);
+
     FastLogDet ivm_custom_class(K);
     auto ivm_custom_function = ivm;
+    NativeSubmodularFunction ivm_native_function(native_ivm);
 
     std::map<std::string, SubmodularOptimizer*> optimizers;
 
@@ -217,50 +241,100 @@ int main() {
     optimizers["Greedy with IVM + RBF"] = new Greedy(K, ivm_rbf);
     optimizers["Greedy with IVM + poly kernel class"] = new Greedy(K, ivm_custom_kernel_class);
     optimizers["Greedy with IVM + poly kernel function"] = new Greedy(K, ivm_custom_kernel_function);
+    optimizers["Greedy with IVM + native poly kernel"] = new Greedy(K, ivm_native_kernel);
     optimizers["Greedy with custom IVM class"] = new Greedy(K, ivm_custom_class);
     optimizers["Greedy with custom IVM function"] = new Greedy(K, ivm_custom_function);
+    optimizers["Greedy with native IVM function"] = new Greedy(K, ivm_native_function);
+
+    /* LazyGreedy */
+    optimizers["LazyGreedy with IVM + RBF"] = new LazyGreedy(K, ivm_rbf);
+    optimizers["LazyGreedy with IVM + poly kernel class"] = new LazyGreedy(K, ivm_custom_kernel_class);
+    optimizers["LazyGreedy with custom IVM class"] = new LazyGreedy(K, ivm_custom_class);
+    optimizers["LazyGreedy with native IVM function"] = new LazyGreedy(K, ivm_native_function);
+
+    /* StochasticGreedy */
+    optimizers["StochasticGreedy with IVM + RBF"] = new StochasticGreedy(K, ivm_rbf, 0.01, 12345);
+    optimizers["StochasticGreedy with IVM + poly kernel class"] = new StochasticGreedy(K, ivm_custom_kernel_class, 0.01, 12345);
+    optimizers["StochasticGreedy with custom IVM class"] = new StochasticGreedy(K, ivm_custom_class, 0.01, 12345);
+    optimizers["StochasticGreedy with native IVM function"] = new StochasticGreedy(K, ivm_native_function, 0.01, 12345);
+
+    /* ParallelGreedy */
+    optimizers["ParallelGreedy with IVM + RBF"] = new ParallelGreedy(K, ivm_rbf, 4);
+    optimizers["ParallelGreedy with IVM + poly kernel class"] = new ParallelGreedy(K, ivm_custom_kernel_class, 4);
+    optimizers["ParallelGreedy with custom IVM class"] = new ParallelGreedy(K, ivm_custom_class, 4);
+    optimizers["ParallelGreedy with native IVM function"] = new ParallelGreedy(K, ivm_native_function, 4);
+
+    /* PartitionedGreedy */
+    optimizers["PartitionedGreedy with IVM + RBF"] = new PartitionedGreedy(K, ivm_rbf, 4, 2, 12345);
+    optimizers["PartitionedGreedy with IVM + poly kernel class"] = new PartitionedGreedy(K, ivm_custom_kernel_class, 4, 2, 12345);
+    optimizers["PartitionedGreedy with custom IVM class"] = new PartitionedGreedy(K, ivm_custom_class, 4, 2, 12345);
+    optimizers["PartitionedGreedy with native IVM function"] = new PartitionedGreedy(K, ivm_native_function, 4, 2, 12345);
+
+    /* IVMGreedy */
+    optimizers["IVMGreedy with IVM + RBF"] = new IVMGreedy(K, ivm_rbf);
+    optimizers["IVMGreedy with IVM + poly kernel class"] = new IVMGreedy(K, ivm_custom_kernel_class);
+    optimizers["IVMGreedy with IVM + poly kernel function"] = new IVMGreedy(K, poly_kernel, 1.0);
+    optimizers["IVMGreedy with IVM + native poly kernel"] = new IVMGreedy(K, ivm_native_kernel);
 
     /* Random */
     optimizers["Random with IVM + RBF"] = new Random(K, ivm_rbf, 12345);
     optimizers["Random with IVM + poly kernel class"] = new Random(K, ivm_custom_kernel_class, 22222);
     optimizers["Random with IVM + poly kernel function"] = new Random(K, ivm_custom_kernel_function, 22222);
+    optimizers["Random with IVM + native poly kernel"] = new Random(K, ivm_native_kernel, 22222);
     optimizers["Random with custom IVM class"] = new Random(K, ivm_custom_class, 12345);
     optimizers["Random with custom IVM function"] = new Random(K, ivm_custom_function,12345);
+    optimizers["Random with native IVM function"] = new Random(K, ivm_native_function,12345);
 
     /* IndependentSetImprovement */ 
     optimizers["IndependentSetImprovement with IVM + RBF"] = new IndependentSetImprovement(K, ivm_rbf);
     optimizers["IndependentSetImprovement with IVM + poly kernel class"] = new IndependentSetImprovement(K, ivm_custom_kernel_class);
     optimizers["IndependentSetImprovement with IVM + poly kernel function"] = new IndependentSetImprovement(K, ivm_custom_kernel_function);
+    optimizers["IndependentSetImprovement with IVM + native poly kernel"] = new IndependentSetImprovement(K, ivm_native_kernel);
     optimizers["IndependentSetImprovement with custom IVM class"] = new IndependentSetImprovement(K, ivm_custom_class);
     optimizers["IndependentSetImprovement with custom IVM function"] = new IndependentSetImprovement(K, ivm_custom_function);
+    optimizers["IndependentSetImprovement with native IVM function"] = new IndependentSetImprovement(K, ivm_native_function);
 
     /* SieveStreaming */ 
     optimizers["SieveStreaming with IVM + RBF"] = new SieveStreaming(K, ivm_rbf, 1.0, 0.1);
     optimizers["SieveStreaming with IVM + poly kernel class"] = new SieveStreaming(K, ivm_custom_kernel_class, 1.0, 0.5);
     optimizers["SieveStreaming with IVM + poly kernel function"] = new SieveStreaming(K, ivm_custom_kernel_function, 1.0, 0.5);
+    optimizers["SieveStreaming with IVM + native poly kernel"] = new SieveStreaming(K, ivm_native_kernel, 1.0, 0.5);
     optimizers["SieveStreaming with custom IVM class"] = new SieveStreaming(K, ivm_custom_class, 1.0, 0.1);
     optimizers["SieveStreaming with custom IVM function"] = new SieveStreaming(K, ivm_custom_function, 1.0, 0.1);
+    optimizers["SieveStreaming with native IVM function"] = new SieveStreaming(K, ivm_native_function, 1.0, 0.1);
+    optimizers["SieveStreaming (4 threads) with IVM + RBF"] = new SieveStreaming(K, ivm_rbf, 1.0, 0.1, 4);
+    optimizers["SieveStreaming (4 threads) with IVM + poly kernel class"] = new SieveStreaming(K, ivm_custom_kernel_class, 1.0, 0.5, 4);
 
     /* SieveStreamingPP */ 
     optimizers["SieveStreamingPP with IVM + RBF"] = new SieveStreamingPP(K, ivm_rbf, 1.0, 0.1);
     optimizers["SieveStreamingPP with IVM + poly kernel class"] = new SieveStreamingPP(K, ivm_custom_kernel_class, 1.0, 0.1);
     optimizers["SieveStreamingPP with IVM + poly kernel function"] = new SieveStreamingPP(K, ivm_custom_kernel_function, 1.0, 0.1);
+    optimizers["SieveStreamingPP with IVM + native poly kernel"] = new SieveStreamingPP(K, ivm_native_kernel, 1.0, 0.1);
     optimizers["SieveStreamingPP with custom IVM class"] = new SieveStreamingPP(K, ivm_custom_class, 1.0, 0.1);
     optimizers["SieveStreamingPP with custom IVM function"] = new SieveStreamingPP(K, ivm_custom_function, 1.0, 0.1);
+    optimizers["SieveStreamingPP with native IVM function"] = new SieveStreamingPP(K, ivm_native_function, 1.0, 0.1);
+    optimizers["SieveStreamingPP (4 threads) with IVM + RBF"] = new SieveStreamingPP(K, ivm_rbf, 1.0, 0.1, 4);
+    optimizers["SieveStreamingPP (4 threads) with IVM + poly kernel class"] = new SieveStreamingPP(K, ivm_custom_kernel_class, 1.0, 0.1, 4);
 
     /* Salsa */ 
     optimizers["Salsa with IVM + RBF"] = new Salsa(K, ivm_rbf, 1.0, 0.1);
     optimizers["Salsa with IVM + poly kernel class"] = new Salsa(K, ivm_custom_kernel_class, 1.0, 0.1);
     optimizers["Salsa with IVM + poly kernel function"] = new Salsa(K, ivm_custom_kernel_function, 1.0, 0.1);
+    optimizers["Salsa with IVM + native poly kernel"] = new Salsa(K, ivm_native_kernel, 1.0, 0.1);
     optimizers["Salsa with custom IVM class"] = new Salsa(K, ivm_custom_class, 1.0, 0.1);
     optimizers["Salsa with custom IVM function"] = new Salsa(K, ivm_custom_function, 1.0, 0.1);
+    optimizers["Salsa with native IVM function"] = new Salsa(K, ivm_native_function, 1.0, 0.1);
+    optimizers["Salsa (4 threads) with IVM + RBF"] = new Salsa(K, ivm_rbf, 1.0, 0.1, 0.05, 0.1, 0.025, 0.8, 10, 0.2, 1.0 / 6.0, 4);
+    optimizers["Salsa (4 threads) with IVM + poly kernel class"] = new Salsa(K, ivm_custom_kernel_class, 1.0, 0.1, 0.05, 0.1, 0.025, 0.8, 10, 0.2, 1.0 / 6.0, 4);
 
     /* ThreeSieves */ 
     optimizers["ThreeSieves with IVM + RBF"] = new ThreeSieves(K, ivm_rbf, 1.0, 0.1, "sieve",5);
     optimizers["ThreeSieves with IVM + poly kernel class"] = new ThreeSieves(K, ivm_custom_kernel_class, 1.0, 0.01, "sieve",1);
     optimizers["ThreeSieves with IVM + poly kernel function"] = new ThreeSieves(K, ivm_custom_kernel_function, 1.0, 0.01, "sieve",1);
+    optimizers["ThreeSieves with IVM + native poly kernel"] = new ThreeSieves(K, ivm_native_kernel, 1.0, 0.01, "sieve",1);
     optimizers["ThreeSieves with custom IVM class"] = new ThreeSieves(K, ivm_custom_class, 1.0, 0.1, "sieve",5);
     optimizers["ThreeSieves with custom IVM function"] = new ThreeSieves(K, ivm_custom_function, 1.0, 0.1, "sieve",5);
+    optimizers["ThreeSieves with native IVM function"] = new ThreeSieves(K, ivm_native_function, 1.0, 0.1, "sieve",5);
 
     bool failed = false;
     for (auto& [name, opt] : optimizers) {
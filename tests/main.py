@@ -2,14 +2,22 @@
 
 import numpy as np
 import sys
+import ctypes
 from numpy.linalg import slogdet
 
 from PySSM import Kernel
 from PySSM import RBFKernel
+from PySSM import NativeKernel
 from PySSM import IVM, FastIVM
 from PySSM import SubmodularFunction
+from PySSM import NativeSubmodularFunction
 
 from PySSM import Greedy
+from PySSM import IVMGreedy
+from PySSM import LazyGreedy
+from PySSM import StochasticGreedy
+from PySSM import ParallelGreedy
+from PySSM import PartitionedGreedy
 from PySSM import Random
 from PySSM import SieveStreaming
 from PySSM import SieveStreamingPP
@@ -29,6 +37,12 @@ class PolyKernel(Kernel):
 def poly_kernel(x1,x2):
     return np.dot(np.array(x1), np.array(x2))/len(x1)
 
+# Polynomial kernel / linear kernel implemented as a native callback. In practice you would probably use numba.cfunc 
+# to compile this function, but ctypes works just as well for testing
+@ctypes.CFUNCTYPE(ctypes.c_double, ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_double), ctypes.c_long)
+def native_poly_kernel(x1, x2, dim):
+    return sum(x1[i]*x2[i] for i in range(dim))/dim
+
 # Compute the kernel matrix + its logdet
 def ivm(X):
     X = np.array(X)
@@ -45,6 +59,13 @@ def ivm(X):
                 kmat[j][i] = kval / 1.0**2
     return slogdet(kmat)[1]
 
+# Same as above, but as a native callback which receives the solution as a contiguous n x dim array
+@ctypes.CFUNCTYPE(ctypes.c_double, ctypes.POINTER(ctypes.c_double), ctypes.c_long, ctypes.c_long)
+def native_ivm(X, n, dim):
+    if n == 0:
+        return 0.0
+    return ivm(np.ctypeslib.as_array(X, shape=(n, dim)))
+
 # This is a dummy implementation of the IVM function which caches the kernel matrix
 class FastLogdet(SubmodularFunction):
     def __init__(self, K):
@@ -151,8 +172,11 @@ kernel = PolyKernel()
 ivm_custom_kernel_class = FastIVM(K, kernel = kernel, sigma = 1.0)
 ivm_custom_kernel_function = FastIVM(K, kernel = poly_kernel, sigma = 1.0)
 
+ivm_native_kernel = FastIVM(K, kernel = NativeKernel(ctypes.cast(native_poly_kernel, ctypes.c_void_p).value), sigma = 1.0)
+
 ivm_custom_class = FastLogdet(K)
 ivm_custom_function = ivm
+ivm_native_function = NativeSubmodularFunction(ctypes.cast(native_ivm, ctypes.c_void_p).value)
 
 optimizers = {}
 
@@ -160,8 +184,40 @@ optimizers = {}
 optimizers["Greedy with IVM + RBF"] = Greedy(K, ivm_rbf)
 optimizers["Greedy with IVM + poly kernel class"] = Greedy(K, ivm_custom_kernel_class)
 optimizers["Greedy with IVM + poly kernel function"] = Greedy(K, ivm_custom_kernel_function)
+optimizers["Greedy with IVM + native poly kernel"] = Greedy(K, ivm_native_kernel)
 optimizers["Greedy with custom IVM class"] = Greedy(K, ivm_custom_class)
 optimizers["Greedy with custom IVM function"] = Greedy(K, ivm_custom_function)
+optimizers["Greedy with native IVM function"] = Greedy(K, ivm_native_function)
+
+### LazyGreedy ### 
+optimizers["LazyGreedy with IVM + RBF"] = LazyGreedy(K, ivm_rbf)
+optimizers["LazyGreedy with IVM + poly kernel class"] = LazyGreedy(K, ivm_custom_kernel_class)
+optimizers["LazyGreedy with custom IVM class"] = LazyGreedy(K, ivm_custom_class)
+optimizers["LazyGreedy with native IVM function"] = LazyGreedy(K, ivm_native_function)
+
+### StochasticGreedy ### 
+optimizers["StochasticGreedy with IVM + RBF"] = StochasticGreedy(K, ivm_rbf, 0.01, 12345)
+optimizers["StochasticGreedy with IVM + poly kernel class"] = StochasticGreedy(K, ivm_custom_kernel_class, 0.01, 12345)
+optimizers["StochasticGreedy with custom IVM class"] = StochasticGreedy(K, ivm_custom_class, 0.01, 12345)
+optimizers["StochasticGreedy with native IVM function"] = StochasticGreedy(K, ivm_native_function, 0.01, 12345)
+
+### ParallelGreedy ### 
+optimizers["ParallelGreedy with IVM + RBF"] = ParallelGreedy(K, ivm_rbf, 4)
+optimizers["ParallelGreedy with IVM + poly kernel class"] = ParallelGreedy(K, ivm_custom_kernel_class, 4)
+optimizers["ParallelGreedy with custom IVM class"] = ParallelGreedy(K, ivm_custom_class, 4)
+optimizers["ParallelGreedy with native IVM function"] = ParallelGreedy(K, ivm_native_function, 4)
+
+### PartitionedGreedy ### 
+optimizers["PartitionedGreedy with IVM + RBF"] = PartitionedGreedy(K, ivm_rbf, 4, 2, 12345)
+optimizers["PartitionedGreedy with IVM + poly kernel class"] = PartitionedGreedy(K, ivm_custom_kernel_class, 4, 2, 12345)
+optimizers["PartitionedGreedy with custom IVM class"] = PartitionedGreedy(K, ivm_custom_class, 4, 2, 12345)
+optimizers["PartitionedGreedy with native IVM function"] = PartitionedGreedy(K, ivm_native_function, 4, 2, 12345)
+
+### IVMGreedy ### 
+optimizers["IVMGreedy with IVM + RBF"] = IVMGreedy(K, ivm_rbf)
+optimizers["IVMGreedy with IVM + poly kernel class"] = IVMGreedy(K, ivm_custom_kernel_class)
+optimizers["IVMGreedy with IVM + poly kernel function"] = IVMGreedy(K, poly_kernel, 1.0)
+optimizers["IVMGreedy with IVM + native poly kernel"] = IVMGreedy(K, ivm_native_kernel)
 
 ### Random ### 
 # We "optimize" over the random seeds so that the solution matches the target solution and we do not need to distinguish 
@@ -169,43 +225,61 @@ optimizers["Greedy with custom IVM function"] = Greedy(K, ivm_custom_function)
 optimizers["Random with IVM + RBF"] = Random(K, ivm_rbf, 12345)
 optimizers["Random with IVM + poly kernel class"] = Random(K, ivm_custom_kernel_class, 22222)
 optimizers["Random with IVM + poly kernel function"] = Random(K, ivm_custom_kernel_function, 22222)
+optimizers["Random with IVM + native poly kernel"] = Random(K, ivm_native_kernel, 22222)
 optimizers["Random with custom IVM class"] = Random(K, ivm_custom_class, 12345)
 optimizers["Random with custom IVM function"] = Random(K, ivm_custom_function, 12345)
+optimizers["Random with native IVM function"] = Random(K, ivm_native_function, 12345)
 
 ### IndependentSetImprovement ### 
 optimizers["IndependentSetImprovement with IVM + RBF"] = IndependentSetImprovement(K, ivm_rbf)
 optimizers["IndependentSetImprovement with IVM + poly kernel class"] = IndependentSetImprovement(K, ivm_custom_kernel_class)
 optimizers["IndependentSetImprovement with IVM + poly kernel function"] = IndependentSetImprovement(K, ivm_custom_kernel_function)
+optimizers["IndependentSetImprovement with IVM + native poly kernel"] = IndependentSetImprovement(K, ivm_native_kernel)
 optimizers["IndependentSetImprovement with custom IVM class"] = IndependentSetImprovement(K, ivm_custom_class)
 optimizers["IndependentSetImprovement with custom IVM function"] = IndependentSetImprovement(K, ivm_custom_function)
+optimizers["IndependentSetImprovement with native IVM function"] = IndependentSetImprovement(K, ivm_native_function)
 
 ### SieveStreaming ### 
 optimizers["SieveStreaming with IVM + RBF"] = SieveStreaming(K, ivm_rbf, 1.0, 0.1)
 optimizers["SieveStreaming with IVM + poly kernel class"] = SieveStreaming(K, ivm_custom_kernel_class, 1.0, 0.5)
 optimizers["SieveStreaming with IVM + poly kernel function"] = SieveStreaming(K, ivm_custom_kernel_function, 1.0, 0.5)
+optimizers["SieveStreaming with IVM + native poly kernel"] = SieveStreaming(K, ivm_native_kernel, 1.0, 0.5)
 optimizers["SieveStreaming with custom IVM class"] = SieveStreaming(K, ivm_custom_class, 1.0, 0.1)
 optimizers["SieveStreaming with custom IVM function"] = SieveStreaming(K, ivm_custom_function, 1.0, 0.1)
+optimizers["SieveStreaming with native IVM function"] = SieveStreaming(K, ivm_native_function, 1.0, 0.1)
+optimizers["SieveStreaming (4 threads) with IVM + RBF"] = SieveStreaming(K, ivm_rbf, 1.0, 0.1, 4)
+optimizers["SieveStreaming (4 threads) with IVM + poly kernel class"] = SieveStreaming(K, ivm_custom_kernel_class, 1.0, 0.5, 4)
 
 ### SieveStreamingPP ### 
 optimizers["SieveStreamingPP with IVM + RBF"] = SieveStreamingPP(K, ivm_rbf, 1.0, 0.1)
 optimizers["SieveStreamingPP with IVM + poly kernel class"] = SieveStreamingPP(K, ivm_custom_kernel_class, 1.0, 0.1)
 optimizers["SieveStreamingPP with IVM + poly kernel function"] = SieveStreamingPP(K, ivm_custom_kernel_function, 1.0, 0.1)
+optimizers["SieveStreamingPP with IVM + native poly kernel"] = SieveStreamingPP(K, ivm_native_kernel, 1.0, 0.1)
 optimizers["SieveStreamingPP with custom IVM class"] = SieveStreamingPP(K, ivm_custom_class, 1.0, 0.1)
 optimizers["SieveStreamingPP with custom IVM function"] = SieveStreamingPP(K, ivm_custom_function, 1.0, 0.1)
+optimizers["SieveStreamingPP with native IVM function"] = SieveStreamingPP(K, ivm_native_function, 1.0, 0.1)
+optimizers["SieveStreamingPP (4 threads) with IVM + RBF"] = SieveStreamingPP(K, ivm_rbf, 1.0, 0.1, 4)
+optimizers["SieveStreamingPP (4 threads) with IVM + poly kernel class"] = SieveStreamingPP(K, ivm_custom_kernel_class, 1.0, 0.1, 4)
 
 ### Salsa ### 
 optimizers["Salsa with IVM + RBF"] = Salsa(K, ivm_rbf, 1.0, 0.1)
 optimizers["Salsa with IVM + poly kernel class"] = Salsa(K, ivm_custom_kernel_class, 1.0, 0.1)
 optimizers["Salsa with IVM + poly kernel function"] = Salsa(K, ivm_custom_kernel_function, 1.0, 0.1)
+optimizers["Salsa with IVM + native poly kernel"] = Salsa(K, ivm_native_kernel, 1.0, 0.1)
 optimizers["Salsa with custom IVM class"] = Salsa(K, ivm_custom_class, 1.0, 0.1)
 optimizers["Salsa with custom IVM function"] = Salsa(K, ivm_custom_function, 1.0, 0.1)
+optimizers["Salsa with native IVM function"] = Salsa(K, ivm_native_function, 1.0, 0.1)
+optimizers["Salsa (4 threads) with IVM + RBF"] = Salsa(K, ivm_rbf, 1.0, 0.1, num_threads=4)
+optimizers["Salsa (4 threads) with IVM + poly kernel class"] = Salsa(K, ivm_custom_kernel_class, 1.0, 0.1, num_threads=4)
 
 ### ThreeSieves ### 
 optimizers["ThreeSieves with IVM + RBF"] = ThreeSieves(K, ivm_rbf, 1.0, 0.1, "sieve",5)
 optimizers["ThreeSieves with IVM + poly kernel class"] = ThreeSieves(K, ivm_custom_kernel_class, 1.0, 0.01, "sieve",1)
 optimizers["ThreeSieves with IVM + poly kernel function"] = ThreeSieves(K, ivm_custom_kernel_function, 1.0, 0.01, "sieve",1)
+optimizers["ThreeSieves with IVM + native poly kernel"] = ThreeSieves(K, ivm_native_kernel, 1.0, 0.01, "sieve",1)
 optimizers["ThreeSieves with custom IVM class"] = ThreeSieves(K, ivm_custom_class, 1.0, 0.1, "sieve",5)
 optimizers["ThreeSieves with custom IVM function"] = ThreeSieves(K, ivm_custom_function, 1.0, 0.1, "sieve",5)
+optimizers["ThreeSieves with native IVM function"] = ThreeSieves(K, ivm_native_function, 1.0, 0.1, "sieve",5)
 
 failed = False
 for name, opt in optimizers.items():